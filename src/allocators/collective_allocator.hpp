@@ -21,9 +21,11 @@
 #ifndef argo_collective_allocators_hpp
 #define argo_collective_allocators_hpp argo_collective_allocators_hpp
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <stack>
+#include <vector>
 
 #include "../mempools/dynamic_mempool.hpp"
 #include "../mempools/global_mempool.hpp"
@@ -284,6 +286,226 @@ namespace argo {
 		}
 		collective_free(static_cast<void*>(ptr));
 	}
+
+	/**
+	 * @brief Scope for collective allocations that synchronize only once
+	 *
+	 * Constructing many objects with conew_ or conew_array costs one or two
+	 * barriers per object. A collective_batch instead reserves and
+	 * initializes all objects created through it without synchronizing, and
+	 * makes them visible to all nodes with a single barrier in commit(). The
+	 * destructor commits any outstanding work.
+	 *
+	 * Objects deleted through a batch are deinitialized on their home node
+	 * when the batch is committed, and their memory is returned to the
+	 * collective allocator after the barrier.
+	 *
+	 * The initialization parameters (@ref allocation) are honoured as in
+	 * conew_ and codelete_, while all synchronization is deferred to
+	 * commit(). Like all collective allocation, the batch and all of its
+	 * member functions need to be called by all nodes with the same arguments
+	 * and in the same order.
+	 *
+	 * @warning Objects allocated through a batch may only be accessed by
+	 *          other nodes after the batch has been committed.
+	 * @warning Unlike collective_alloc, allocating through a batch does not
+	 *          synchronize first. Memory that was freed without
+	 *          synchronization may be handed out again before other nodes
+	 *          stopped using it.
+	 */
+	class collective_batch {
+		private:
+			/** @brief Deinitializations to run on commit */
+			std::vector<std::function<void()>> deinitializers;
+
+			/** @brief Memory to return to the collective allocator on commit */
+			std::vector<void*> deallocations;
+
+			/** @brief Whether anything was allocated or deleted since the last commit */
+			bool pending;
+
+			/**
+			 * @brief Decide whether allocated objects are initialized
+			 * @tparam T type to construct
+			 * @tparam APs Allocation parameters
+			 * @param arguments whether the user provided constructor arguments
+			 * @return true if the home node should construct the object(s)
+			 * @sa conew_
+			 */
+			template<typename T, allocation... APs>
+			static bool do_initialize(bool arguments) {
+				using aps = _internal::alloc_params<APs...>;
+				bool initialize = !std::is_trivial<T>::value || arguments;
+				if (aps::initialize) {
+					initialize = true;
+				} else if (aps::no_initialize) {
+					initialize = false;
+				}
+				return initialize;
+			}
+
+			/**
+			 * @brief Decide whether deleted objects are deinitialized
+			 * @tparam T type to destruct
+			 * @tparam APs Deallocation parameters
+			 * @return true if the home node should destruct the object(s)
+			 * @sa codelete_
+			 */
+			template<typename T, allocation... APs>
+			static bool do_deinitialize() {
+				using aps = _internal::alloc_params<APs...>;
+				bool deinitialize = !std::is_trivially_destructible<T>::value;
+				if (aps::deinitialize) {
+					deinitialize = true;
+				} else if (aps::no_deinitialize) {
+					deinitialize = false;
+				}
+				return deinitialize;
+			}
+
+		public:
+			/**
+			 * @brief Start a batch of collective allocations
+			 * @param bytes Total number of bytes the batch is expected to allocate
+			 *
+			 * If bytes is given, the collective memory pool is grown at
+			 * most once up front, so that no further synchronization is
+			 * needed for allocations of up to that size within the batch.
+			 */
+			explicit collective_batch(std::size_t bytes = 0) : pending(false) {
+				if (bytes > 0) {
+					allocators::default_collective_allocator.reserve(bytes);
+				}
+			}
+
+			/** @brief Commit the batch */
+			~collective_batch() {
+				commit();
+			}
+
+			/** @brief A batch can not be copied */
+			collective_batch(const collective_batch&) = delete;
+			/** @brief A batch can not be copied */
+			collective_batch& operator=(const collective_batch&) = delete;
+
+			/**
+			 * @brief Construct a new object within the batch
+			 * @tparam T type to construct
+			 * @tparam APs Allocation parameters
+			 * @tparam Ps parameter types for constructor
+			 * @param ps parameters for constructor
+			 * @return pointer to newly constructed object
+			 * @sa conew_
+			 */
+			template<typename T, allocation... APs, typename... Ps>
+			T* new_(Ps&&... ps) {
+				void* ptr = allocators::default_collective_allocator.allocate(sizeof(T));
+				using namespace data_distribution;
+				global_ptr<void> gptr(ptr);
+				if (do_initialize<T, APs...>(sizeof...(Ps) > 0) &&
+						argo::backend::node_id() == gptr.node()) {
+					new (ptr) T(std::forward<Ps>(ps)...);
+				}
+				pending = true;
+				return static_cast<T*>(ptr);
+			}
+
+			/**
+			 * @brief Construct a new array of objects within the batch
+			 * @tparam T type to construct
+			 * @tparam APs Allocation parameters
+			 * @param size Number of elements in the array
+			 * @return A pointer to the newly constructed array
+			 * @sa conew_array
+			 */
+			template<typename T, allocation... APs>
+			T* new_array(std::size_t size) {
+				void* ptr = allocators::default_collective_allocator.allocate(sizeof(T) * size);
+				using namespace data_distribution;
+				global_ptr<void> gptr(ptr);
+				if (do_initialize<T, APs...>(false) &&
+						argo::backend::node_id() == gptr.node()) {
+					new (ptr) T[size]();
+				}
+				pending = true;
+				return static_cast<T*>(ptr);
+			}
+
+			/**
+			 * @brief Delete an object when the batch is committed
+			 * @tparam T type of the object to deallocate
+			 * @tparam APs Deallocation parameters
+			 * @param ptr pointer to the object to deallocate
+			 * @sa codelete_
+			 */
+			template<typename T, allocation... APs>
+			void delete_(T* ptr) {
+				if (ptr == nullptr) {
+					return;
+				}
+				using namespace data_distribution;
+				global_ptr<T> gptr(ptr);
+				if (do_deinitialize<T, APs...>() &&
+						argo::backend::node_id() == gptr.node()) {
+					deinitializers.push_back([ptr]() { ptr->~T(); });
+				}
+				deallocations.push_back(static_cast<void*>(ptr));
+				pending = true;
+			}
+
+			/**
+			 * @brief Delete an array of objects when the batch is committed
+			 * @tparam T type of the objects to deallocate
+			 * @tparam APs Deallocation parameters
+			 * @param ptr pointer to the array to deallocate
+			 * @sa codelete_array
+			 */
+			template<typename T, allocation... APs>
+			void delete_array(T* ptr) {
+				if (ptr == nullptr) {
+					return;
+				}
+				using namespace data_distribution;
+				global_ptr<T> gptr(ptr);
+				if (do_deinitialize<T, APs...>() &&
+						argo::backend::node_id() == gptr.node()) {
+					auto elements =
+						allocators::default_collective_allocator.allocated_space(
+							reinterpret_cast<char*>(ptr)) / sizeof(T);
+					deinitializers.push_back([ptr, elements]() {
+						for (std::size_t i = 0; i < elements; ++i) {
+							ptr[i].~T();
+						}
+					});
+				}
+				deallocations.push_back(static_cast<void*>(ptr));
+				pending = true;
+			}
+
+			/**
+			 * @brief Synchronize all allocations and deletions of the batch
+			 *
+			 * Runs the pending deinitializations, synchronizes all nodes
+			 * once and releases the memory of deleted objects. The batch
+			 * can be used again afterwards. If nothing happened since the
+			 * last commit, no synchronization is performed.
+			 */
+			void commit() {
+				if (!pending) {
+					return;
+				}
+				for (auto& deinitialize : deinitializers) {
+					deinitialize();
+				}
+				deinitializers.clear();
+				argo::backend::barrier();
+				for (auto ptr : deallocations) {
+					collective_free(ptr);
+				}
+				deallocations.clear();
+				pending = false;
+			}
+	};
 } // namespace argo
 
 #endif /* argo_collective_allocators_hpp */
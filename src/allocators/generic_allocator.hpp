@@ -171,6 +171,22 @@ namespace argo {
 					freelist[size].push(ptr);
 				}
 
+				/**
+				 * @brief helper function for growing the memory pool
+				 * @param n minimum number of elements the pool must hold after growing
+				 * @details this helper is used internally after locks have been acquired.
+				 *          Any memory left in the pool is moved to the freelist first.
+				 */
+				void grow_nosync(size_t n) {
+					auto avail = mempool->available();
+					if(avail > 0) {
+						T* leftover = static_cast<T*>(mempool->reserve(avail));
+						freelist[avail].push(leftover);
+						allocation_size.insert({{leftover, avail}});
+					}
+					mempool->grow(n*sizeof(T));
+				}
+
 			public:
 				/**
 				 * @brief the type that is allocated
@@ -219,14 +235,8 @@ namespace argo {
 					try {
 						allocation = static_cast<T*>(mempool->reserve(n*sizeof(T)));
 					} catch (const typename MemoryPool::bad_alloc&) {
-						auto avail = mempool->available();
-						if(avail > 0) {
-							allocation = static_cast<T*>(mempool->reserve(avail));
-							freelist[avail].push(allocation);
-							allocation_size.insert({{allocation, n}});
-						}
 						try {
-							mempool->grow(n*sizeof(T));
+							grow_nosync(n);
 						}catch(const std::bad_alloc&){
 							lock->unlock();
 							throw;
@@ -238,6 +248,27 @@ namespace argo {
 					return allocation;
 				}
 
+				/**
+				 * @brief Prepare the memory pool for upcoming allocations
+				 * @param n The amount of Ts that should be allocatable without growing
+				 * @details If the memory pool cannot hold n more Ts, it is grown
+				 *          once to fit all of them. Later calls to allocate()
+				 *          for up to n Ts in total are then served without
+				 *          growing the pool again.
+				 */
+				void reserve(size_t n) {
+					lock->lock();
+					if(mempool->available() < n*sizeof(T)) {
+						try {
+							grow_nosync(n);
+						}catch(const std::bad_alloc&){
+							lock->unlock();
+							throw;
+						}
+					}
+					lock->unlock();
+				}
+
 				/**
 				 * @brief free an allocated pointer
 				 * @param ptr the pointer to free
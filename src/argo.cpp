@@ -9,6 +9,7 @@
 #include "allocators/collective_allocator.hpp"
 #include "allocators/dynamic_allocator.hpp"
 #include "env/env.hpp"
+#include "topology/topology.hpp"
 #include "virtual_memory/virtual_memory.hpp"
 
 namespace vm = argo::virtual_memory;
@@ -24,6 +25,8 @@ mem::dynamic_memory_pool<alloc::global_allocator, mem::ALWAYS> dynamic_prepool(&
 namespace argo {
 	void init(std::size_t argo_size, std::size_t cache_size) {
 		env::init();
+		/* detect the topology before any thread is pinned */
+		topology::init();
 		vm::init();
 
 		std::size_t requested_argo_size = argo_size;
@@ -10,6 +10,7 @@
 #include <stddef.h>
 
 #include "allocators/allocators.h"
+#include "coherence/coherence.h"
 #include "synchronization/synchronization.h"
 
 /**
@@ -11,6 +11,12 @@
 
 #include "allocators/allocators.hpp"
 #include "backend/backend.hpp"
+#include "coherence/coherence.hpp"
+#include "data_distribution/local_ranges.hpp"
+#include "communication/accumulate.hpp"
+#include "communication/collective.hpp"
+#include "communication/invoke.hpp"
+#include "communication/onesided.hpp"
 #include "types/types.hpp"
 #include "synchronization/synchronization.hpp"
 
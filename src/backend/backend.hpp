@@ -10,8 +10,12 @@
 #define argo_backend_backend_hpp argo_backend_backend_hpp
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <initializer_list>
 #include <stdexcept>
+#include <vector>
 
 #include "../data_distribution/global_ptr.hpp"
 #include "../types/types.hpp"
@@ -105,6 +109,412 @@ namespace argo {
 		template<typename T>
 		void broadcast(node_id_t source, T* ptr);
 
+		/**
+		 * @brief handle of a team of nodes, see argo::team
+		 */
+		using team_handle = std::size_t;
+
+		/**
+		 * @brief create a team of nodes
+		 * @param members the nodes of the team, in increasing order and
+		 *                including the calling node
+		 * @param count the number of nodes in the team
+		 * @return the handle of the team
+		 * @note Collective over the members of the team only.
+		 */
+		team_handle team_create(const node_id_t* members, std::size_t count);
+
+		/**
+		 * @brief destroy a team of nodes
+		 * @param team the handle of the team
+		 * @note Collective over the members of the team only.
+		 */
+		void team_free(team_handle team);
+
+		/**
+		 * @brief a barrier over the members of a team
+		 * @param team the handle of the team
+		 * @param threadcount number of threads on each member that go into the barrier
+		 * @details Writes back the cache as barrier() does, but only
+		 *          invalidates data written by members of the team.
+		 */
+		void team_barrier(team_handle team, std::size_t threadcount);
+
+		/**
+		 * @brief Backend internal type erased broadcast within a team
+		 * @param team the handle of the team
+		 * @param source the member holding the authoritative copy
+		 * @param ptr pointer to the object to synchronize
+		 * @param size the size of the object in bytes
+		 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		void _team_broadcast(team_handle team, node_id_t source, void* ptr, std::size_t size);
+
+		/**
+		 * @brief self-invalidate the data written by the members of a team
+		 * @param team the handle of the team
+		 */
+		void team_acquire(team_handle team);
+
+		/**
+		 * @brief make the writes of this node visible to the members of a team
+		 * @param team the handle of the team
+		 * @note As members may read pages they have not accessed before,
+		 *       all dirty pages are written back, as by release().
+		 */
+		void team_release(team_handle team);
+
+		/**
+		 * @brief Backend internal type erased allreduce function for signed integers
+		 * @param value Pointer to the value of the calling thread, replaced by the result
+		 * @param op The operation combining the values
+		 * @param size The size of the value
+		 * @param threadcount number of threads on each node that take part
+		 * @sa allreduce
+		 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		void _allreduce_int(void* value, reduction_op op, std::size_t size, std::size_t threadcount);
+
+		/**
+		 * @brief Backend internal type erased allreduce function for unsigned integers
+		 * @param value Pointer to the value of the calling thread, replaced by the result
+		 * @param op The operation combining the values
+		 * @param size The size of the value
+		 * @param threadcount number of threads on each node that take part
+		 * @sa allreduce
+		 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		void _allreduce_uint(void* value, reduction_op op, std::size_t size, std::size_t threadcount);
+
+		/**
+		 * @brief Backend internal type erased allreduce function for floating point numbers
+		 * @param value Pointer to the value of the calling thread, replaced by the result
+		 * @param op The operation combining the values
+		 * @param size The size of the value
+		 * @param threadcount number of threads on each node that take part
+		 * @sa allreduce
+		 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		void _allreduce_float(void* value, reduction_op op, std::size_t size, std::size_t threadcount);
+
+		/**
+		 * @brief Backend internal type erased reduce function for signed integers
+		 * @param value Pointer to the value of the calling thread, replaced by the result
+		 * @param op The operation combining the values
+		 * @param size The size of the value
+		 * @param root The node receiving the result
+		 * @param threadcount number of threads on each node that take part
+		 * @sa reduce
+		 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		void _reduce_int(void* value, reduction_op op, std::size_t size, node_id_t root,
+			std::size_t threadcount);
+
+		/**
+		 * @brief Backend internal type erased reduce function for unsigned integers
+		 * @param value Pointer to the value of the calling thread, replaced by the result
+		 * @param op The operation combining the values
+		 * @param size The size of the value
+		 * @param root The node receiving the result
+		 * @param threadcount number of threads on each node that take part
+		 * @sa reduce
+		 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		void _reduce_uint(void* value, reduction_op op, std::size_t size, node_id_t root,
+			std::size_t threadcount);
+
+		/**
+		 * @brief Backend internal type erased reduce function for floating point numbers
+		 * @param value Pointer to the value of the calling thread, replaced by the result
+		 * @param op The operation combining the values
+		 * @param size The size of the value
+		 * @param root The node receiving the result
+		 * @param threadcount number of threads on each node that take part
+		 * @sa reduce
+		 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		void _reduce_float(void* value, reduction_op op, std::size_t size, node_id_t root,
+			std::size_t threadcount);
+
+		/**
+		 * @brief a collective reduction that also acts as a barrier
+		 * @tparam T the type of the values to reduce
+		 * @param value the value of the calling thread
+		 * @param op the operation combining the values
+		 * @param threadcount number of threads on each node that take part
+		 * @return the values of all threads on all nodes combined by op
+		 * @details The values of the threads on a node are combined before
+		 *          a single value per node is reduced across the nodes. The
+		 *          reduction synchronizes the memory as barrier() does, in
+		 *          the same single collective operation.
+		 */
+		template<typename T>
+		T allreduce(T value, reduction_op op, std::size_t threadcount = 1) {
+			static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type");
+			// The order is important here, as floats are signed as well
+			if (std::is_floating_point<T>::value)
+				_allreduce_float(&value, op, sizeof(T), threadcount);
+			else if (std::is_unsigned<T>::value)
+				_allreduce_uint(&value, op, sizeof(T), threadcount);
+			else
+				_allreduce_int(&value, op, sizeof(T), threadcount);
+			return value;
+		}
+
+		/**
+		 * @brief a collective reduction to a single node
+		 * @tparam T the type of the values to reduce
+		 * @param value the value of the calling thread
+		 * @param op the operation combining the values
+		 * @param root the node receiving the result
+		 * @param threadcount number of threads on each node that take part
+		 * @return on the root node, the values of all threads on all nodes
+		 *         combined by op, and an unspecified value on other nodes
+		 * @note Unlike allreduce(), this does not synchronize the memory.
+		 */
+		template<typename T>
+		T reduce(T value, reduction_op op, node_id_t root, std::size_t threadcount = 1) {
+			static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type");
+			// The order is important here, as floats are signed as well
+			if (std::is_floating_point<T>::value)
+				_reduce_float(&value, op, sizeof(T), root, threadcount);
+			else if (std::is_unsigned<T>::value)
+				_reduce_uint(&value, op, sizeof(T), root, threadcount);
+			else
+				_reduce_int(&value, op, sizeof(T), root, threadcount);
+			return value;
+		}
+
+		/**
+		 * @brief handle of an asynchronous operation of the backend
+		 * @details Tickets of a node are issued in increasing order, and
+		 *          the operations complete in the same order.
+		 */
+		using ticket = std::uint64_t;
+
+		/**
+		 * @brief start loading a range of the global memory into the cache
+		 * @param addr the start of the range
+		 * @param size the size of the range in bytes
+		 * @return a ticket to wait for the prefetch with
+		 * @note The range is loaded as if it were read, so the coherence
+		 *       of the prefetched data is the same as for a read at the
+		 *       time it is loaded.
+		 */
+		ticket prefetch(void* addr, std::size_t size);
+
+		/**
+		 * @brief set the access hints of a range of the global memory
+		 * @param addr the start of the range
+		 * @param size the size of the range in bytes
+		 * @param hints the hints, replacing the earlier hints of the range
+		 * @note The hints apply to every page overlapping the range, and
+		 *       only on this node. Cached copies of pages whose coherence
+		 *       hints change are written back and dropped.
+		 */
+		void advise(void* addr, std::size_t size, advice hints);
+
+		/**
+		 * @brief Backend internal check whether a page is valid on this node
+		 * @param addr an address in the page
+		 * @return true if the page can be read without loading it,
+		 *         which pages homed on this node always can
+		 * @warning For internal use only, e.g. by tests of the coherence
+		 *          hints - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		bool _is_cached(const void* addr);
+
+		/**
+		 * @brief Backend internal check of the directory of this node
+		 * @param addr an address in the page
+		 * @param node the node to check for
+		 * @return true if node is registered as a sharer of the page in
+		 *         the directory of this node
+		 * @note The directory of the home node of a page knows of every
+		 *       registered sharer.
+		 * @warning For internal use only, e.g. by tests of the coherence
+		 *          hints - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		bool _is_sharer(const void* addr, node_id_t node);
+
+		/**
+		 * @brief wait until an asynchronous operation has completed
+		 * @param t the ticket of the operation
+		 */
+		void wait(ticket t);
+
+		/**
+		 * @brief check whether an asynchronous operation has completed
+		 * @param t the ticket of the operation
+		 * @return true if the operation has completed
+		 */
+		bool test(ticket t);
+
+		/**
+		 * @brief copy a range of the global memory into a local buffer
+		 * @param dst the local buffer
+		 * @param src the start of the range in the global memory
+		 * @param size the size of the range in bytes
+		 * @throws std::invalid_argument if dst is in the global memory, or
+		 *         the range is outside of it
+		 * @note The data is read directly from the home nodes, except for
+		 *       cache lines this node holds a valid copy of, which are
+		 *       read from the cache so that the node sees its own writes.
+		 */
+		void get(void* dst, const void* src, std::size_t size);
+
+		/**
+		 * @brief copy a local buffer into a range of the global memory
+		 * @param dst the start of the range in the global memory
+		 * @param src the local buffer
+		 * @param size the size of the range in bytes
+		 * @throws std::invalid_argument if src is in the global memory, or
+		 *         the range is outside of it
+		 * @note The data is written directly to the home nodes. Cached
+		 *       copies of the range are written back and invalidated
+		 *       first, and other nodes see the data after their next
+		 *       acquire, as for a regular write.
+		 */
+		void put(void* dst, const void* src, std::size_t size);
+
+		/**
+		 * @brief copy elements of the global memory into a local buffer
+		 * @param dst the local buffer, receiving the elements in order
+		 * @param base the global address the offsets are relative to
+		 * @param offsets the offset of each element from base in bytes
+		 * @param count the number of elements
+		 * @param size the size of an element in bytes
+		 * @throws std::invalid_argument if dst is in the global memory, or an
+		 *         element is outside of it or crosses a cache line boundary
+		 * @note The elements are read as by get().
+		 */
+		void gather(void* dst, const void* base, const std::ptrdiff_t* offsets,
+				std::size_t count, std::size_t size);
+
+		/**
+		 * @brief copy a local buffer into elements of the global memory
+		 * @param base the global address the offsets are relative to
+		 * @param src the local buffer, holding the elements in order
+		 * @param offsets the offset of each element from base in bytes,
+		 *                which must not overlap
+		 * @param count the number of elements
+		 * @param size the size of an element in bytes
+		 * @throws std::invalid_argument if src is in the global memory, or an
+		 *         element is outside of it or crosses a cache line boundary
+		 * @note The elements are written as by put().
+		 */
+		void scatter(void* base, const void* src, const std::ptrdiff_t* offsets,
+				std::size_t count, std::size_t size);
+
+		/**
+		 * @brief collectively fill a range of the global memory with a pattern
+		 * @param dst the start of the range
+		 * @param pattern the pattern to repeat over the range
+		 * @param pattern_size the size of the pattern in bytes
+		 * @param size the size of the range in bytes
+		 * @throws std::invalid_argument if the pattern is empty
+		 * @note Must be called by one thread on every node with the same
+		 *       arguments. Every node fills the parts of the range homed on
+		 *       it, and the call synchronizes as a barrier before and after.
+		 */
+		void fill(void* dst, const void* pattern, std::size_t pattern_size, std::size_t size);
+
+		/**
+		 * @brief collectively copy a range of the global memory
+		 * @param dst the start of the destination range
+		 * @param src the start of the source range
+		 * @param size the size of the ranges in bytes
+		 * @throws std::invalid_argument if the ranges overlap
+		 * @note Must be called as fill(). Every node copies into the parts
+		 *       of the destination homed on it, reading the source from
+		 *       the home nodes.
+		 */
+		void copy(void* dst, const void* src, std::size_t size);
+
+		/**
+		 * @brief collectively load a range of the global memory into the caches of all nodes
+		 * @param addr the start of the range
+		 * @param size the size of the range in bytes
+		 * @param root the node whose view of the range is sent
+		 * @throws std::invalid_argument if root is not a node
+		 * @note Must be called as fill(). The call synchronizes as a
+		 *       barrier before the range is sent, and all nodes can read
+		 *       the range without misses afterwards, as far as their caches
+		 *       hold it.
+		 */
+		void broadcast_range(void* addr, std::size_t size, node_id_t root);
+
+		/**
+		 * @brief find the memory backing a range homed on this node
+		 * @param addr the start of the range in the global memory
+		 * @param size the size of the range in bytes
+		 * @param write true if the range is written through the result
+		 * @return a pointer to the backing memory of the range, or nullptr
+		 *         if size is zero
+		 * @throws std::invalid_argument if the range is not homed on this
+		 *         node in one contiguous part of its memory
+		 * @note If write is set, the range is prepared as for put(), so
+		 *       that other nodes see writes through the result after their
+		 *       next acquire.
+		 */
+		void* local_view(void* addr, std::size_t size, bool write);
+
+		/**
+		 * @brief calls a registered function on an object at its home node
+		 * @details The first argument is the registered function, which the
+		 *          caller casts back to its real type before calling it with
+		 *          the object, the argument and the buffer for the result.
+		 */
+		using home_function = void (*)(void (*)(), void* object, const void* arg, void* result);
+
+		/**
+		 * @brief register a function to run at the home node of its object
+		 * @param fn the function
+		 * @param call calls fn at the home node
+		 * @note Must be called for the same functions in the same order on
+		 *       all nodes. Registering a function again has no effect.
+		 */
+		void register_function(void (*fn)(), home_function call);
+
+		/**
+		 * @brief run a registered function at the home node of an object
+		 * @param object the object in the global memory
+		 * @param object_size the size of the object in bytes
+		 * @param fn the registered function
+		 * @param arg the argument of the function, which is copied
+		 * @param arg_size the size of the argument in bytes
+		 * @param result_size the size of the result of the function in bytes
+		 * @param done called with the result, or nullptr if the function
+		 *             threw, once the function has run
+		 * @throws std::invalid_argument if fn is not registered, or the
+		 *         object crosses a page boundary
+		 * @note The functions run one at a time on each home node. The
+		 *       object is updated as by put() from this node.
+		 */
+		void invoke_at_home(void* object, std::size_t object_size, void (*fn)(),
+				const void* arg, std::size_t arg_size, std::size_t result_size,
+				std::function<void(const void*)> done);
+
+		/**
+		 * @brief start copying a range of the global memory into a local buffer
+		 * @param dst the local buffer
+		 * @param src the start of the range in the global memory
+		 * @param size the size of the range in bytes
+		 * @return a ticket to wait for the copy with
+		 * @see get()
+		 */
+		ticket get_async(void* dst, const void* src, std::size_t size);
+
+		/**
+		 * @brief start copying a local buffer into a range of the global memory
+		 * @param dst the start of the range in the global memory
+		 * @param src the local buffer
+		 * @param size the size of the range in bytes
+		 * @return a ticket to wait for the copy with
+		 * @see put()
+		 */
+		ticket put_async(void* dst, const void* src, std::size_t size);
+
 		/**
 		 * @brief causes a node to self-invalidate its cache,
 		 *        and thus getting any updated values on subsequent accesses
@@ -118,6 +528,16 @@ namespace argo {
 		 */
 		void release();
 
+		/**
+		 * @brief start a release in the background
+		 * @return a ticket to wait for the release with
+		 * @details The writes of the node are propagated to their home
+		 *          nodes by the asynchronous worker. The release is
+		 *          complete at the latest when the next acquire, barrier
+		 *          or allreduce of the node returns.
+		 */
+		ticket release_async();
+
 
 		/**
 		 * The following selective coherence functions are implemented individually
@@ -142,6 +562,34 @@ namespace argo {
 		 */
 		void _selective_release(void* addr, std::size_t size);
 
+		/**
+		 * @brief a range of the global memory for selective coherence
+		 */
+		struct memory_range {
+			/** @brief pointer to the start of the range */
+			void* addr;
+			/** @brief size of the range in bytes */
+			std::size_t size;
+		};
+
+		/**
+		 * @brief backend internal function for selective acquire of several ranges
+		 * @param ranges the ranges of the global memory
+		 * @param count the number of ranges
+		 * @sa    selective_acquire
+		 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		void _selective_acquire(const memory_range* ranges, std::size_t count);
+
+		/**
+		 * @brief backend internal function for selective release of several ranges
+		 * @param ranges the ranges of the global memory
+		 * @param count the number of ranges
+		 * @sa    selective_release
+		 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+		 */
+		void _selective_release(const memory_range* ranges, std::size_t count);
+
 		/**
 		 * The following selective coherence functions are generic interfaces to the
 		 * actual backend implementations
@@ -180,6 +628,46 @@ namespace argo {
 			_selective_release(static_cast<void*>(addr), size);
 		}
 
+		/**
+		 * @brief causes a node to self-invalidate the pages of several memory regions
+		 * @param ranges the memory regions, e.g. {{a, a_size}, {b, b_size}}.
+		 *        Regions with a size of zero are skipped.
+		 * @details The regions are handled as by selective_acquire(T*, std::size_t),
+		 *          but in a single critical section, with the write backs of
+		 *          dirty pages completed once per home node.
+		 */
+		inline void selective_acquire(const std::vector<memory_range>& ranges) {
+			_selective_acquire(ranges.data(), ranges.size());
+		}
+
+		/**
+		 * @brief causes a node to self-invalidate the pages of several memory regions
+		 * @see selective_acquire(const std::vector<memory_range>&)
+		 */
+		inline void selective_acquire(std::initializer_list<memory_range> ranges) {
+			_selective_acquire(ranges.begin(), ranges.size());
+		}
+
+		/**
+		 * @brief causes a node to self-downgrade the pages of several memory regions
+		 * @param ranges the memory regions, e.g. {{a, a_size}, {b, b_size}}.
+		 *        Regions with a size of zero are skipped.
+		 * @details The regions are handled as by selective_release(T*, std::size_t),
+		 *          but in a single critical section, with the write backs of
+		 *          dirty pages completed once per home node.
+		 */
+		inline void selective_release(const std::vector<memory_range>& ranges) {
+			_selective_release(ranges.data(), ranges.size());
+		}
+
+		/**
+		 * @brief causes a node to self-downgrade the pages of several memory regions
+		 * @see selective_release(const std::vector<memory_range>&)
+		 */
+		inline void selective_release(std::initializer_list<memory_range> ranges) {
+			_selective_release(ranges.begin(), ranges.size());
+		}
+
 		namespace atomic {
 			using namespace argo::atomic;
 
@@ -250,6 +738,25 @@ namespace argo {
 			void _store_local_offsets_tbl(const std::size_t desired,
 				const std::size_t rank, const std::size_t disp);
 
+			/**
+			 * @brief Number of words available in the lock buffer of each node
+			 * @note The lock buffer is used by the global MCS lock to provide
+			 *       one queue node (two words) per lock instance and node.
+			 */
+			constexpr std::size_t lockbuffer_words = 512;
+
+			/**
+			 * @brief Backend internal atomic store function for the lock buffer
+			 * @param desired The desired value to be stored
+			 * @param rank Rank of the node whose lock buffer is written to
+			 * @param disp Index of the target word in the lock buffer
+			 * @note Implementation-specific function for the global MCS lock.
+			 *       It is used to perform stores on the lockWindow window.
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _store_lockbuffer(const std::size_t desired,
+				const node_id_t rank, const std::size_t disp);
+
 			/**
 			 * @brief Backend internal type erased atomic store function
 			 * @param obj Pointer to the object whose value should be exchanged
@@ -301,6 +808,27 @@ namespace argo {
 			void _load_local_offsets_tbl(void* output_buffer,
 				const std::size_t rank, const std::size_t disp);
 
+			/**
+			 * @brief Backend internal atomic load function for the local lock buffer
+			 * @param output_buffer Pointer to the memory location where the value should be stored
+			 * @param disp Index of the word in the lock buffer of the calling node
+			 * @note Implementation-specific function for the global MCS lock.
+			 *       It is used to perform loads on the lockWindow window.
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _load_local_lockbuffer(std::size_t* output_buffer,
+				const std::size_t disp);
+
+			/**
+			 * @brief Backend internal access to a word of the local lock buffer
+			 * @param disp Index of the word in the lock buffer of the calling node
+			 * @return Address of the word, to poll without synchronization
+			 * @note The polled value may lag behind the stores of other nodes,
+			 *       so it must be confirmed with _load_local_lockbuffer.
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			const volatile std::size_t* _local_lockbuffer_word(const std::size_t disp);
+
 			/**
 			 * @brief Backend internal type erased atomic CAS function
 			 * @param obj Pointer to the object whose value should be exchanged
@@ -380,6 +908,169 @@ namespace argo {
 			void _fetch_add_float(global_ptr<void> obj, void* value, std::size_t size,
 				void* output_buffer);
 
+			/**
+			 * @brief Backend internal type erased atomic fetch and combine function for signed integers
+			 * @param obj Pointer to the object to combine with the value
+			 * @param op The operation combining the object and the value
+			 * @param value Pointer to the object that holds the value
+			 * @param size sizeof(*obj) == sizeof(*value) == sizeof(output_buffer)
+			 * @param output_buffer Pointer to the memory location where the old value of the object should be stored
+			 * @sa fetch_op
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _fetch_op_int(global_ptr<void> obj, reduction_op op, void* value,
+				std::size_t size, void* output_buffer);
+			/**
+			 * @brief Backend internal type erased atomic fetch and combine function for unsigned integers
+			 * @param obj Pointer to the object to combine with the value
+			 * @param op The operation combining the object and the value
+			 * @param value Pointer to the object that holds the value
+			 * @param size sizeof(*obj) == sizeof(*value) == sizeof(output_buffer)
+			 * @param output_buffer Pointer to the memory location where the old value of the object should be stored
+			 * @sa fetch_op
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _fetch_op_uint(global_ptr<void> obj, reduction_op op, void* value,
+				std::size_t size, void* output_buffer);
+			/**
+			 * @brief Backend internal type erased atomic fetch and combine function for floating point numbers
+			 * @param obj Pointer to the object to combine with the value
+			 * @param op The operation combining the object and the value
+			 * @param value Pointer to the object that holds the value
+			 * @param size sizeof(*obj) == sizeof(*value) == sizeof(output_buffer)
+			 * @param output_buffer Pointer to the memory location where the old value of the object should be stored
+			 * @sa fetch_op
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _fetch_op_float(global_ptr<void> obj, reduction_op op, void* value,
+				std::size_t size, void* output_buffer);
+
+			/**
+			 * @brief Backend internal type erased non-blocking atomic combine function for signed integers
+			 * @param obj Pointer to the object to combine with the value
+			 * @param op The operation combining the object and the value
+			 * @param value Pointer to the object that holds the value, which may be reused on return
+			 * @param size sizeof(*obj) == sizeof(*value)
+			 * @sa post_op
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _post_op_int(global_ptr<void> obj, reduction_op op, const void* value,
+				std::size_t size);
+			/**
+			 * @brief Backend internal type erased non-blocking atomic combine function for unsigned integers
+			 * @param obj Pointer to the object to combine with the value
+			 * @param op The operation combining the object and the value
+			 * @param value Pointer to the object that holds the value, which may be reused on return
+			 * @param size sizeof(*obj) == sizeof(*value)
+			 * @sa post_op
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _post_op_uint(global_ptr<void> obj, reduction_op op, const void* value,
+				std::size_t size);
+			/**
+			 * @brief Backend internal type erased non-blocking atomic combine function for floating point numbers
+			 * @param obj Pointer to the object to combine with the value
+			 * @param op The operation combining the object and the value
+			 * @param value Pointer to the object that holds the value, which may be reused on return
+			 * @param size sizeof(*obj) == sizeof(*value)
+			 * @sa post_op
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _post_op_float(global_ptr<void> obj, reduction_op op, const void* value,
+				std::size_t size);
+
+			/**
+			 * @brief Complete all non-blocking atomic operations issued by this node
+			 * @sa flush
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _flush_ops();
+
+			/**
+			 * @brief Backend internal type erased range accumulate function for signed integers
+			 * @param segments Pointers to the first element of each segment,
+			 *                 which must be contiguous on its home node
+			 * @param counts The number of elements in each segment
+			 * @param num_segments The number of segments
+			 * @param values The values to combine the elements with, for all
+			 *               segments one after another
+			 * @param op The operation combining the elements and the values
+			 * @param size The size of each element
+			 * @sa argo::accumulate
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _accumulate_int(const global_ptr<void>* segments, const std::size_t* counts,
+				std::size_t num_segments, const void* values, reduction_op op, std::size_t size);
+
+			/**
+			 * @brief Backend internal type erased range accumulate function for unsigned integers
+			 * @param segments Pointers to the first element of each segment,
+			 *                 which must be contiguous on its home node
+			 * @param counts The number of elements in each segment
+			 * @param num_segments The number of segments
+			 * @param values The values to combine the elements with, for all
+			 *               segments one after another
+			 * @param op The operation combining the elements and the values
+			 * @param size The size of each element
+			 * @sa argo::accumulate
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _accumulate_uint(const global_ptr<void>* segments, const std::size_t* counts,
+				std::size_t num_segments, const void* values, reduction_op op, std::size_t size);
+
+			/**
+			 * @brief Backend internal type erased range accumulate function for floating point numbers
+			 * @param segments Pointers to the first element of each segment,
+			 *                 which must be contiguous on its home node
+			 * @param counts The number of elements in each segment
+			 * @param num_segments The number of segments
+			 * @param values The values to combine the elements with, for all
+			 *               segments one after another
+			 * @param op The operation combining the elements and the values
+			 * @param size The size of each element
+			 * @sa argo::accumulate
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _accumulate_float(const global_ptr<void>* segments, const std::size_t* counts,
+				std::size_t num_segments, const void* values, reduction_op op, std::size_t size);
+
+			/**
+			 * @brief Backend internal type erased batched atomic (post)increment function for signed integers
+			 * @param objs Pointers to the objects whose values should be incremented
+			 * @param values Pointer to the values to add, one per object
+			 * @param count Number of objects
+			 * @param size sizeof(*objs[i]) == sizeof(values[i]) == sizeof(output_buffer[i])
+			 * @param output_buffer Pointer to the memory location where the old values of the objects should be stored
+			 * @sa fetch_add_many
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _fetch_add_many_int(const global_ptr<void>* objs, const void* values,
+				std::size_t count, std::size_t size, void* output_buffer);
+			/**
+			 * @brief Backend internal type erased batched atomic (post)increment function for unsigned integers
+			 * @param objs Pointers to the objects whose values should be incremented
+			 * @param values Pointer to the values to add, one per object
+			 * @param count Number of objects
+			 * @param size sizeof(*objs[i]) == sizeof(values[i]) == sizeof(output_buffer[i])
+			 * @param output_buffer Pointer to the memory location where the old values of the objects should be stored
+			 * @sa fetch_add_many
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _fetch_add_many_uint(const global_ptr<void>* objs, const void* values,
+				std::size_t count, std::size_t size, void* output_buffer);
+			/**
+			 * @brief Backend internal type erased batched atomic (post)increment function for floating point numbers
+			 * @param objs Pointers to the objects whose values should be incremented
+			 * @param values Pointer to the values to add, one per object
+			 * @param count Number of objects
+			 * @param size sizeof(*objs[i]) == sizeof(values[i]) == sizeof(output_buffer[i])
+			 * @param output_buffer Pointer to the memory location where the old values of the objects should be stored
+			 * @sa fetch_add_many
+			 * @warning For internal use only - DO NOT USE UNLESS YOU KNOW WHAT YOU ARE DOING
+			 */
+			void _fetch_add_many_float(const global_ptr<void>* objs, const void* values,
+				std::size_t count, std::size_t size, void* output_buffer);
+
 			/**
 			 * The following atomic functions are generic interfaces to the
 			 * actual backend implementations
@@ -610,6 +1301,260 @@ namespace argo {
 
 				return out_buffer;
 			}
+
+			/**
+			 * @brief Atomic fetch and combine operation on a global address
+			 * @param obj Pointer to the global object to combine with the value
+			 * @param op The operation to apply
+			 * @param value The value to combine the object with
+			 * @param order Memory synchronization ordering for this operation
+			 * @tparam T The type of the object to operate upon
+			 * @tparam U The type of the value object
+			 * @return The value of the object BEFORE the operation
+			 *
+			 * This function will perform an atomic (*obj) = op(*obj, value)
+			 * operation. The bitwise operations are only available for
+			 * integer types.
+			 */
+			template <typename T, typename U>
+			T fetch_op(global_ptr<T> obj, reduction_op op, U value, memory_order order = memory_order::acq_rel) {
+				T out_buffer;
+				static_assert(std::is_arithmetic<T>::value,
+					"T must be an arithmetic type");
+				static_assert(std::is_convertible<U, T>::value,
+					"It is not possible to implicitly convert \'value\' to an"
+					" object of type T.");
+				T value_buffer(value);
+
+				if (order == memory_order::acq_rel || order == memory_order::release)
+					release();
+
+				// The order is important here, as floats are signed as well
+				if (std::is_floating_point<T>::value)
+					_fetch_op_float(global_ptr<void>(obj), op, &value_buffer, sizeof(T), &out_buffer);
+				else if (std::is_unsigned<T>::value)
+					_fetch_op_uint(global_ptr<void>(obj), op, &value_buffer, sizeof(T), &out_buffer);
+				else
+					_fetch_op_int(global_ptr<void>(obj), op, &value_buffer, sizeof(T), &out_buffer);
+
+				if (order == memory_order::acq_rel || order == memory_order::acquire)
+					acquire();
+
+				return out_buffer;
+			}
+
+			/**
+			 * @brief Atomic fetch and minimum operation on a global address
+			 * @param obj Pointer to the global object
+			 * @param value The value to compare the object with
+			 * @param order Memory synchronization ordering for this operation
+			 * @return The value of the object BEFORE the operation
+			 * @sa fetch_op
+			 */
+			template <typename T, typename U>
+			T fetch_min(global_ptr<T> obj, U value, memory_order order = memory_order::acq_rel) {
+				return fetch_op(obj, reduction_op::min, value, order);
+			}
+
+			/**
+			 * @brief Atomic fetch and maximum operation on a global address
+			 * @param obj Pointer to the global object
+			 * @param value The value to compare the object with
+			 * @param order Memory synchronization ordering for this operation
+			 * @return The value of the object BEFORE the operation
+			 * @sa fetch_op
+			 */
+			template <typename T, typename U>
+			T fetch_max(global_ptr<T> obj, U value, memory_order order = memory_order::acq_rel) {
+				return fetch_op(obj, reduction_op::max, value, order);
+			}
+
+			/**
+			 * @brief Atomic fetch and bitwise and operation on a global address
+			 * @param obj Pointer to the global object
+			 * @param value The value to combine the object with
+			 * @param order Memory synchronization ordering for this operation
+			 * @return The value of the object BEFORE the operation
+			 * @sa fetch_op
+			 */
+			template <typename T, typename U>
+			T fetch_and(global_ptr<T> obj, U value, memory_order order = memory_order::acq_rel) {
+				static_assert(std::is_integral<T>::value, "T must be an integer type");
+				return fetch_op(obj, reduction_op::bitwise_and, value, order);
+			}
+
+			/**
+			 * @brief Atomic fetch and bitwise or operation on a global address
+			 * @param obj Pointer to the global object
+			 * @param value The value to combine the object with
+			 * @param order Memory synchronization ordering for this operation
+			 * @return The value of the object BEFORE the operation
+			 * @sa fetch_op
+			 */
+			template <typename T, typename U>
+			T fetch_or(global_ptr<T> obj, U value, memory_order order = memory_order::acq_rel) {
+				static_assert(std::is_integral<T>::value, "T must be an integer type");
+				return fetch_op(obj, reduction_op::bitwise_or, value, order);
+			}
+
+			/**
+			 * @brief Atomic fetch and bitwise exclusive or operation on a global address
+			 * @param obj Pointer to the global object
+			 * @param value The value to combine the object with
+			 * @param order Memory synchronization ordering for this operation
+			 * @return The value of the object BEFORE the operation
+			 * @sa fetch_op
+			 */
+			template <typename T, typename U>
+			T fetch_xor(global_ptr<T> obj, U value, memory_order order = memory_order::acq_rel) {
+				static_assert(std::is_integral<T>::value, "T must be an integer type");
+				return fetch_op(obj, reduction_op::bitwise_xor, value, order);
+			}
+
+			/**
+			 * @brief Non-blocking atomic combine operation on a global address
+			 * @param obj Pointer to the global object to combine with the value
+			 * @param op The operation to apply
+			 * @param value The value to combine the object with
+			 * @tparam T The type of the object to operate upon
+			 * @tparam U The type of the value object
+			 *
+			 * This function will perform an atomic (*obj) = op(*obj, value)
+			 * operation without waiting for it to complete, and without
+			 * returning the old value. Such operations are relaxed: they
+			 * complete at the latest when flush() is called, or at the next
+			 * release or barrier of this node. Each operation is atomic with
+			 * respect to all other atomic operations.
+			 */
+			template <typename T, typename U>
+			void post_op(global_ptr<T> obj, reduction_op op, U value) {
+				static_assert(std::is_arithmetic<T>::value,
+					"T must be an arithmetic type");
+				static_assert(std::is_convertible<U, T>::value,
+					"It is not possible to implicitly convert \'value\' to an"
+					" object of type T.");
+				T value_buffer(value);
+
+				// The order is important here, as floats are signed as well
+				if (std::is_floating_point<T>::value)
+					_post_op_float(global_ptr<void>(obj), op, &value_buffer, sizeof(T));
+				else if (std::is_unsigned<T>::value)
+					_post_op_uint(global_ptr<void>(obj), op, &value_buffer, sizeof(T));
+				else
+					_post_op_int(global_ptr<void>(obj), op, &value_buffer, sizeof(T));
+			}
+
+			/**
+			 * @brief Non-blocking atomic add operation on a global address
+			 * @param obj Pointer to the global object to add to
+			 * @param value The value to add to the object
+			 * @sa post_op
+			 */
+			template <typename T, typename U>
+			void add(global_ptr<T> obj, U value) {
+				post_op(obj, reduction_op::sum, value);
+			}
+
+			/**
+			 * @brief Non-blocking atomic bitwise and operation on a global address
+			 * @param obj Pointer to the global object
+			 * @param value The value to combine the object with
+			 * @sa post_op
+			 */
+			template <typename T, typename U>
+			void band(global_ptr<T> obj, U value) {
+				static_assert(std::is_integral<T>::value, "T must be an integer type");
+				post_op(obj, reduction_op::bitwise_and, value);
+			}
+
+			/**
+			 * @brief Non-blocking atomic bitwise or operation on a global address
+			 * @param obj Pointer to the global object
+			 * @param value The value to combine the object with
+			 * @sa post_op
+			 */
+			template <typename T, typename U>
+			void bor(global_ptr<T> obj, U value) {
+				static_assert(std::is_integral<T>::value, "T must be an integer type");
+				post_op(obj, reduction_op::bitwise_or, value);
+			}
+
+			/**
+			 * @brief Non-blocking atomic bitwise exclusive or operation on a global address
+			 * @param obj Pointer to the global object
+			 * @param value The value to combine the object with
+			 * @sa post_op
+			 */
+			template <typename T, typename U>
+			void bxor(global_ptr<T> obj, U value) {
+				static_assert(std::is_integral<T>::value, "T must be an integer type");
+				post_op(obj, reduction_op::bitwise_xor, value);
+			}
+
+			/**
+			 * @brief Wait until all non-blocking atomic operations of this node are complete
+			 * @details After this call, the effects of all operations issued
+			 *          through post_op() and its variants are visible to
+			 *          atomic operations of all nodes.
+			 */
+			inline void flush() {
+				_flush_ops();
+			}
+
+			/**
+			 * @brief Batched atomic fetch and add operation on global addresses
+			 * @param objs Pointers to the global objects to fetch and add to
+			 * @param values The values to add, one per object
+			 * @param count The number of objects
+			 * @param output_buffer Where to store the values of the objects
+			 *                      BEFORE the add operations, one per object,
+			 *                      or nullptr if they are not needed
+			 * @param order Memory synchronization ordering for the whole batch
+			 * @tparam T The type of the objects to operate upon
+			 * @tparam U The type of the value objects
+			 *
+			 * This function will perform an atomic (*objs[i])+=values[i]
+			 * operation for each object. The operations are issued together
+			 * and completed at once, which is much cheaper than issuing them
+			 * one by one. Each operation is atomic on its own, but the batch
+			 * is not. The same object may appear several times.
+			 */
+			template <typename T, typename U>
+			void fetch_add_many(const global_ptr<T>* objs, const U* values, std::size_t count,
+					T* output_buffer = nullptr, memory_order order = memory_order::acq_rel) {
+				static_assert(std::is_arithmetic<T>::value,
+					"T must be an arithmetic type");
+				static_assert(std::is_convertible<U, T>::value,
+					"It is not possible to implicitly convert \'value\' to an"
+					" object of type T.");
+				std::vector<global_ptr<void>> obj_buffer;
+				std::vector<T> value_buffer;
+				obj_buffer.reserve(count);
+				value_buffer.reserve(count);
+				for (std::size_t i = 0; i < count; i++) {
+					obj_buffer.emplace_back(objs[i]);
+					value_buffer.emplace_back(values[i]);
+				}
+				std::vector<T> out_buffer;
+				if (output_buffer == nullptr) {
+					out_buffer.resize(count);
+					output_buffer = out_buffer.data();
+				}
+
+				if (order == memory_order::acq_rel || order == memory_order::release)
+					release();
+
+				// The order is important here, as floats are signed as well
+				if (std::is_floating_point<T>::value)
+					_fetch_add_many_float(obj_buffer.data(), value_buffer.data(), count, sizeof(T), output_buffer);
+				else if (std::is_unsigned<T>::value)
+					_fetch_add_many_uint(obj_buffer.data(), value_buffer.data(), count, sizeof(T), output_buffer);
+				else
+					_fetch_add_many_int(obj_buffer.data(), value_buffer.data(), count, sizeof(T), output_buffer);
+
+				if (order == memory_order::acq_rel || order == memory_order::acquire)
+					acquire();
+			}
 		} // namespace atomic
 	} // namespace backend
 } // namespace argo
@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @brief This file provides a worker thread for asynchronous backend operations
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_async_worker_hpp
+#define argo_async_worker_hpp argo_async_worker_hpp
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <semaphore.h>
+
+#include "backend/backend.hpp"
+
+/**
+ * @brief	A worker thread executing operations in FIFO order
+ * @details	Every submitted operation is identified by a ticket. Tickets
+ *		are handed out in increasing order and the operations complete
+ *		in the same order, so an operation is complete once the
+ *		number of completed operations has reached its ticket.
+ *		Besides operations, the worker can be passed hints from
+ *		contexts that may neither allocate nor block, which it hands
+ *		to a fixed hint operation when no operations are waiting.
+ */
+class async_worker
+{
+	private:
+		/** @brief type of the handles of submitted operations */
+		using ticket = argo::backend::ticket;
+
+		/** @brief The operations waiting to be executed */
+		std::deque<std::function<void()>> _queue;
+
+		/** @brief Protects the queue and the counters */
+		std::mutex _mutex;
+
+		/** @brief Posted once per submitted operation or hint to wake the worker */
+		sem_t _wakeup;
+
+		/** @brief Value of _hint while no hint is pending */
+		static constexpr std::size_t no_hint = static_cast<std::size_t>(-1);
+
+		/** @brief The latest hint not yet taken by the worker */
+		std::atomic<std::size_t> _hint;
+
+		/** @brief The operation executed for each hint taken */
+		std::function<void(std::size_t)> _hint_op;
+
+		/** @brief Signals completed operations to waiting threads */
+		std::condition_variable _completed;
+
+		/** @brief The ticket of the last submitted operation */
+		ticket _issued;
+
+		/** @brief The ticket of the last completed operation */
+		ticket _done;
+
+		/** @brief Set to stop the worker thread */
+		bool _stop;
+
+		/** @brief The worker thread */
+		std::thread _thread;
+
+		/** @brief Executes operations until stopped */
+		void run() {
+			while(true) {
+				while(sem_wait(&_wakeup) != 0 && errno == EINTR) {}
+				std::unique_lock<std::mutex> lock(_mutex);
+				std::function<void()> op;
+				if(!_queue.empty()) {
+					op = std::move(_queue.front());
+					_queue.pop_front();
+				} else if(_stop) {
+					return;
+				} else {
+					/* hints are taken in order with the operations, so take a ticket */
+					const std::size_t hint = _hint.exchange(no_hint);
+					if(hint == no_hint) {
+						continue;
+					}
+					_issued++;
+					op = [this, hint]{ _hint_op(hint); };
+				}
+				lock.unlock();
+				op();
+				lock.lock();
+				_done++;
+				_completed.notify_all();
+			}
+		}
+
+	public:
+		/**
+		 * @brief	Starts the worker thread
+		 * @param hint_op	The operation to execute for each hint taken
+		 */
+		explicit async_worker(std::function<void(std::size_t)> hint_op)
+			: _hint(no_hint), _hint_op(std::move(hint_op)),
+			_issued(0), _done(0), _stop(false) {
+			sem_init(&_wakeup, 0, 0);
+			_thread = std::thread(&async_worker::run, this);
+		}
+
+		/**
+		 * @brief Completes all submitted operations and stops the worker thread
+		 * @note Pending hints are dropped
+		 */
+		~async_worker() {
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stop = true;
+			}
+			sem_post(&_wakeup);
+			_thread.join();
+			sem_destroy(&_wakeup);
+		}
+
+		/** @brief Copy constructor is not allowed */
+		async_worker(const async_worker&) = delete;
+		/** @brief Copy assignment is not allowed */
+		async_worker& operator=(const async_worker&) = delete;
+
+		/**
+		 * @brief	Queues an operation for execution by the worker thread
+		 * @param op	The operation to execute
+		 * @return	The ticket of the operation
+		 */
+		ticket submit(std::function<void()> op) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_queue.push_back(std::move(op));
+			sem_post(&_wakeup);
+			return ++_issued;
+		}
+
+		/**
+		 * @brief	Passes a hint to the worker thread
+		 * @param value	The hint, which must not be all ones
+		 * @details	Only the latest hint not yet taken is kept. This
+		 *		neither allocates nor blocks, so it is safe to call
+		 *		from a signal handler.
+		 */
+		void hint(std::size_t value) {
+			_hint.store(value);
+			sem_post(&_wakeup);
+		}
+
+		/**
+		 * @brief	Waits until an operation has completed
+		 * @param t	The ticket of the operation
+		 */
+		void wait(ticket t) {
+			std::unique_lock<std::mutex> lock(_mutex);
+			_completed.wait(lock, [this, t]{ return _done >= t; });
+		}
+
+		/**
+		 * @brief	Checks whether an operation has completed
+		 * @param t	The ticket of the operation
+		 * @return	True if the operation has completed
+		 */
+		bool test(ticket t) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			return _done >= t;
+		}
+
+		/** @brief Waits until all submitted operations and hints have completed */
+		void drain() {
+			std::unique_lock<std::mutex> lock(_mutex);
+			_completed.wait(lock, [this]{
+				return _done >= _issued && _hint.load() == no_hint;
+			});
+		}
+};
+
+#endif /* argo_async_worker_hpp */
@@ -30,18 +30,6 @@ extern pthread_mutex_t cachemutex;
  * @deprecated Should not be needed once the cache module is implemented
  */
 extern sem_t ibsem;
-/**
- * @brief barwindowsused is needed to know which globalDataWindows
- * to close.
- * @deprecated No longer needed once proper API functions are in place
- */
-extern char * barwindowsused;
-/**
- * @brief globalDataWindows need to be explicitly closed by the
- * caller of storepageDIFF
- * @deprecated Should eventually be handled through API functions
- */
-extern MPI_Win *globalDataWindow;
 /**
  * @brief sharerWindow protects the pyxis directory
  * @deprecated Should not be needed once the pyxis directory is
@@ -68,138 +56,167 @@ extern MPI_Comm workcomm;
  */
 extern write_buffer<std::size_t>* argo_write_buffer;
 
-namespace argo {
-	namespace backend {
-		void _selective_acquire(void *addr, std::size_t size){
-			if(size == 0){
-				// Nothing to invalidate
-				return;
+namespace {
+	/**
+	 * @brief self-invalidate the pages of a range of the global memory
+	 * @param addr pointer to the start of the range
+	 * @param size size of the range
+	 * @pre cachemutex and ibsem must be held
+	 * @note The write backs of dirty pages must be synced by the caller
+	 */
+	void invalidate_range(void *addr, std::size_t size){
+		const std::size_t block_size = page_size*CACHELINE;
+		const std::size_t start_address = reinterpret_cast<std::size_t>(argo::virtual_memory::start_address());
+		const std::size_t page_misalignment = reinterpret_cast<std::size_t>(addr)%block_size;
+		std::size_t argo_address =
+			((reinterpret_cast<std::size_t>(addr)-start_address)/block_size)*block_size;
+		const std::size_t node_id = argo::backend::node_id();
+		const std::size_t node_id_bit = std::size_t{1} << node_id;
+
+		// Iterate over all pages to selectively invalidate
+		for(std::size_t page_address = argo_address;
+				page_address < argo_address + page_misalignment + size;
+				page_address += block_size){
+			const std::size_t cache_index = getCacheIndex(page_address);
+			const std::size_t classification_index = get_classification_index(page_address);
+
+			// If the page is dirty, downgrade it
+			if(cacheControl[cache_index].dirty == DIRTY){
+				argo_protect_memory((char*)start_address + page_address, block_size, PROT_READ);
+				for(int i = 0; i <CACHELINE; i++){
+					storepageDIFF(cache_index+i,page_address+page_size*i);
+				}
+				argo_write_buffer->erase(cache_index);
+				cacheControl[cache_index].dirty = CLEAN;
 			}
 
-			const std::size_t block_size = page_size*CACHELINE;
-			const std::size_t start_address = reinterpret_cast<std::size_t>(argo::virtual_memory::start_address());
-			const std::size_t page_misalignment = reinterpret_cast<std::size_t>(addr)%block_size;
-			std::size_t argo_address =
-				((reinterpret_cast<std::size_t>(addr)-start_address)/block_size)*block_size;
-			const std::size_t node_id = argo::backend::node_id();
-			const std::size_t node_id_bit = 1 << node_id;
-
-			// Lock relevant mutexes. Start statistics timekeeping
-			double t1 = MPI_Wtime();
-			pthread_mutex_lock(&cachemutex);
-			sem_wait(&ibsem);
-
-			// Iterate over all pages to selectively invalidate
-			for(std::size_t page_address = argo_address;
-					page_address < argo_address + page_misalignment + size;
-					page_address += block_size){
-				const std::size_t cache_index = getCacheIndex(page_address);
-				const std::size_t classification_index = get_classification_index(page_address);
-
-				// If the page is dirty, downgrade it
-				if(cacheControl[cache_index].dirty == DIRTY){
-					mprotect((char*)start_address + page_address, block_size, PROT_READ);
-					for(int i = 0; i <CACHELINE; i++){
-						storepageDIFF(cache_index+i,page_address+page_size*i);
-					}
-					argo_write_buffer->erase(cache_index);
-					cacheControl[cache_index].dirty = CLEAN;
-				}
+			// Read-only and private pages are not changed by other
+			// nodes, as in self_invalidation
+			if(has_advice(page_address, argo::advice::read_only | argo::advice::node_private)){
+				continue;
+			}
 
-				// Optimization to keep pages in cache if they do not
-				// need to be invalidated.
-				MPI_Win_lock(MPI_LOCK_SHARED, node_id, 0, sharerWindow);
-				if(
-						// node is single writer
-						(globalSharers[classification_index+1] == node_id_bit)
-						||
-						// No writer and assert that the node is a sharer
-						((globalSharers[classification_index+1] == 0) &&
-						 ((globalSharers[classification_index] & node_id_bit) == node_id_bit))
-				  ){
-					MPI_Win_unlock(node_id, sharerWindow);
-					touchedcache[cache_index]=1;
-					//nothing - we keep the pages, SD is done in flushWB
-				}
-				else{ //multiple writer or SO, invalidate the page
-					MPI_Win_unlock(node_id, sharerWindow);
-					cacheControl[cache_index].dirty=CLEAN;
-					cacheControl[cache_index].state = INVALID;
-					touchedcache[cache_index]=0;
-					mprotect((char*)start_address + page_address, block_size, PROT_NONE);
-				}
+			// Optimization to keep pages in cache if they do not
+			// need to be invalidated.
+			MPI_Win_lock(MPI_LOCK_SHARED, node_id, 0, sharerWindow);
+			if(
+					// node is single writer
+					(globalSharers[classification_index+1] == node_id_bit)
+					||
+					// No writer and assert that the node is a sharer
+					((globalSharers[classification_index+1] == 0) &&
+					 ((globalSharers[classification_index] & node_id_bit) == node_id_bit))
+			  ){
+				MPI_Win_unlock(node_id, sharerWindow);
+				touchedcache[cache_index]=1;
+				//nothing - we keep the pages, SD is done in flushWB
+			}
+			else{ //multiple writer or SO, invalidate the page
+				MPI_Win_unlock(node_id, sharerWindow);
+				cacheControl[cache_index].dirty=CLEAN;
+				cacheControl[cache_index].state = INVALID;
+				touchedcache[cache_index]=0;
+				argo_protect_memory((char*)start_address + page_address, block_size, PROT_NONE);
 			}
-			// Make sure to sync writebacks
-			for(int i = 0; i < number_of_nodes(); i++){
-				if(barwindowsused[i] == 1){
-					MPI_Win_unlock(i, globalDataWindow[i]); //Sync write backs
-					barwindowsused[i] = 0;
+		}
+	}
+
+	/**
+	 * @brief self-downgrade the pages of a range of the global memory
+	 * @param addr pointer to the start of the range
+	 * @param size size of the range
+	 * @pre cachemutex and ibsem must be held
+	 * @note The write backs of dirty pages must be synced by the caller
+	 */
+	void downgrade_range(void *addr, std::size_t size){
+		const std::size_t block_size = page_size*CACHELINE;
+		const std::size_t start_address = reinterpret_cast<std::size_t>(argo::virtual_memory::start_address());
+		const std::size_t page_misalignment = reinterpret_cast<std::size_t>(addr)%block_size;
+		std::size_t argo_address =
+			((reinterpret_cast<std::size_t>(addr)-start_address)/block_size)*block_size;
+
+		// Iterate over all pages to selectively downgrade
+		for(std::size_t page_address = argo_address;
+				page_address < argo_address + page_misalignment + size;
+				page_address += block_size){
+			const std::size_t cache_index = getCacheIndex(page_address);
+
+			// If the page is dirty, downgrade it
+			if(cacheControl[cache_index].dirty == DIRTY){
+				argo_protect_memory((char*)start_address + page_address, block_size, PROT_READ);
+				for(int i = 0; i <CACHELINE; i++){
+					storepageDIFF(cache_index+i,page_address+page_size*i);
 				}
+				argo_write_buffer->erase(cache_index);
+				cacheControl[cache_index].dirty = CLEAN;
+			}
+		}
+	}
+
+	/**
+	 * @brief apply a selective coherence operation to ranges in one critical section
+	 * @param ranges the ranges of the global memory
+	 * @param count the number of ranges
+	 * @param operation invalidate_range or downgrade_range
+	 * @param time the statistic to add the time spent to
+	 */
+	void for_ranges(const argo::backend::memory_range* ranges, std::size_t count,
+			void (*operation)(void*, std::size_t), double& time){
+		if(count == 0){
+			return;
+		}
+		// Lock relevant mutexes. Start statistics timekeeping
+		double t1 = MPI_Wtime();
+		pthread_mutex_lock(&cachemutex);
+		sem_wait(&ibsem);
+
+		for(std::size_t i = 0; i < count; i++){
+			if(ranges[i].size != 0){
+				operation(ranges[i].addr, ranges[i].size);
 			}
+		}
+		// Make sure to sync writebacks
+		sync_write_backs();
 
-			double t2 = MPI_Wtime();
-			stats.ssitime += t2-t1;
+		double t2 = MPI_Wtime();
+		time += t2-t1;
 
-			// Poke the MPI system to force progress
-			int flag;
-			MPI_Iprobe(MPI_ANY_SOURCE,MPI_ANY_TAG,workcomm,&flag,MPI_STATUS_IGNORE);
+		// Poke the MPI system to force progress
+		int flag;
+		MPI_Iprobe(MPI_ANY_SOURCE,MPI_ANY_TAG,workcomm,&flag,MPI_STATUS_IGNORE);
 
-			// Release relevant mutexes
-			sem_post(&ibsem);
-			pthread_mutex_unlock(&cachemutex);
-		}
+		// Release relevant mutexes
+		sem_post(&ibsem);
+		pthread_mutex_unlock(&cachemutex);
+	}
+} // namespace
 
-		void _selective_release(void *addr, std::size_t size){
+namespace argo {
+	namespace backend {
+		void _selective_acquire(void *addr, std::size_t size){
 			if(size == 0){
-				// Nothing to downgrade
+				// Nothing to invalidate
 				return;
 			}
+			const memory_range range{addr, size};
+			_selective_acquire(&range, 1);
+		}
 
-			const std::size_t block_size = page_size*CACHELINE;
-			const std::size_t start_address = reinterpret_cast<std::size_t>(argo::virtual_memory::start_address());
-			const std::size_t page_misalignment = reinterpret_cast<std::size_t>(addr)%block_size;
-			std::size_t argo_address =
-				((reinterpret_cast<std::size_t>(addr)-start_address)/block_size)*block_size;
-
-			// Lock relevant mutexes. Start statistics timekeeping
-			double t1 = MPI_Wtime();
-			pthread_mutex_lock(&cachemutex);
-			sem_wait(&ibsem);
-
-			// Iterate over all pages to selectively downgrade
-			for(std::size_t page_address = argo_address;
-					page_address < argo_address + page_misalignment + size;
-					page_address += block_size){
-				const std::size_t cache_index = getCacheIndex(page_address);
-
-				// If the page is dirty, downgrade it
-				if(cacheControl[cache_index].dirty == DIRTY){
-					mprotect((char*)start_address + page_address, block_size, PROT_READ);
-					for(int i = 0; i <CACHELINE; i++){
-						storepageDIFF(cache_index+i,page_address+page_size*i);
-					}
-					argo_write_buffer->erase(cache_index);
-					cacheControl[cache_index].dirty = CLEAN;
-				}
-			}
-			// Make sure to sync writebacks
-			for(int i = 0; i < number_of_nodes(); i++){
-				if(barwindowsused[i] == 1){
-					MPI_Win_unlock(i, globalDataWindow[i]); //Sync write backs
-					barwindowsused[i] = 0;
-				}
-			}
-
-			double t2 = MPI_Wtime();
-			stats.ssdtime += t2-t1;
+		void _selective_release(void *addr, std::size_t size){
+			// Even an empty range completes the posted atomic operations
+			const memory_range range{addr, size};
+			_selective_release(&range, 1);
+		}
 
-			// Poke the MPI system to force progress
-			int flag;
-			MPI_Iprobe(MPI_ANY_SOURCE,MPI_ANY_TAG,workcomm,&flag,MPI_STATUS_IGNORE);
+		void _selective_acquire(const memory_range* ranges, std::size_t count){
+			// Do not overtake the pending releases of this node
+			argo_wait_for_releases();
+			for_ranges(ranges, count, &invalidate_range, stats.ssitime);
+		}
 
-			// Release relevant mutexes
-			sem_post(&ibsem);
-			pthread_mutex_unlock(&cachemutex);
+		void _selective_release(const memory_range* ranges, std::size_t count){
+			atomic::_flush_ops();
+			for_ranges(ranges, count, &downgrade_range, stats.ssdtime);
 		}
 	} //namespace backend
 } //namespace argo
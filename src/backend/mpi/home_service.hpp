@@ -0,0 +1,346 @@
+/**
+ * @file
+ * @brief This file provides a service thread running functions at the home node of their data
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_home_service_hpp
+#define argo_home_service_hpp argo_home_service_hpp
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+#include <semaphore.h>
+
+#include "backend/backend.hpp"
+
+/**
+ * @brief	A service thread executing invocations sent by other nodes
+ * @details	Each node runs one service thread, which receives requests to
+ *		run a registered function on an object homed on the node, runs
+ *		them one at a time directly on the backing memory and sends
+ *		back the results. It also receives the results of the requests
+ *		of its own node.
+ *
+ *		The MPI library only provides serialized thread support, so the
+ *		thread polls for messages on its own communicator instead of
+ *		blocking in MPI, taking the MPI lock for every call. The
+ *		communicator is set up collectively with the service, but the
+ *		thread is only started by the first registered function, so
+ *		nodes not using the service do not poll.
+ */
+class home_service
+{
+	private:
+		/** @brief type of the functions called at the home node */
+		using home_function = argo::backend::home_function;
+
+		/** @brief type of the continuations receiving the results */
+		using continuation = std::function<void(const void*)>;
+
+		/** @brief Tag of requests */
+		static const int request_tag = 0;
+		/** @brief Tag of replies */
+		static const int reply_tag = 1;
+
+		/** @brief The header of a request */
+		struct request_header {
+			/** @brief the sequence number of the request on its node */
+			std::uint64_t sequence;
+			/** @brief the index of the function in the registry */
+			std::uint64_t function;
+			/** @brief the offset of the object in the backing memory of the home node */
+			std::uint64_t local;
+			/** @brief the size of the result in bytes */
+			std::uint64_t result_size;
+		};
+
+		/** @brief The header of a reply */
+		struct reply_header {
+			/** @brief the sequence number of the request */
+			std::uint64_t sequence;
+			/** @brief zero if the function completed, nonzero if it threw */
+			std::uint64_t failed;
+		};
+
+		/** @brief A send in progress and the buffer it is sent from */
+		struct pending_send {
+			/** @brief the MPI request of the send */
+			MPI_Request request;
+			/** @brief the message */
+			std::vector<char> buffer;
+		};
+
+		/** @brief The communicator the messages are exchanged on */
+		MPI_Comm _comm;
+
+		/** @brief The lock serializing all MPI calls */
+		sem_t* _mpi_lock;
+
+		/** @brief The backing memory of the objects homed on this node */
+		char* _backing;
+
+		/** @brief Protects all members below */
+		std::mutex _mutex;
+
+		/** @brief Signals completed requests of this node */
+		std::condition_variable _completed;
+
+		/** @brief The registered functions and their callers */
+		std::vector<std::pair<void (*)(), home_function>> _functions;
+
+		/** @brief The index of each registered function */
+		std::unordered_map<void (*)(), std::uint64_t> _function_index;
+
+		/** @brief The continuations of the requests waiting for their reply */
+		std::unordered_map<std::uint64_t, continuation> _waiting;
+
+		/** @brief The sends in progress */
+		std::list<pending_send> _sends;
+
+		/** @brief The sequence number of the next request */
+		std::uint64_t _sequence;
+
+		/** @brief Set to stop the service thread */
+		bool _stop;
+
+		/** @brief Set once the service thread is started */
+		std::atomic<bool> _running;
+
+		/** @brief The service thread */
+		std::thread _thread;
+
+		/**
+		 * @brief	Starts sending a message
+		 * @param buffer	The message
+		 * @param node	The receiving node
+		 * @param tag	The tag of the message
+		 */
+		void send(std::vector<char> buffer, int node, int tag) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_sends.emplace_back();
+			pending_send& s = _sends.back();
+			s.buffer = std::move(buffer);
+			sem_wait(_mpi_lock);
+			MPI_Isend(s.buffer.data(), s.buffer.size(), MPI_BYTE, node, tag, _comm, &s.request);
+			sem_post(_mpi_lock);
+		}
+
+		/** @brief Frees the buffers of completed sends */
+		void complete_sends() {
+			std::lock_guard<std::mutex> lock(_mutex);
+			for(auto it = _sends.begin(); it != _sends.end();) {
+				int done;
+				sem_wait(_mpi_lock);
+				MPI_Test(&it->request, &done, MPI_STATUS_IGNORE);
+				sem_post(_mpi_lock);
+				it = done ? _sends.erase(it) : std::next(it);
+			}
+		}
+
+		/**
+		 * @brief	Runs a requested function and replies with its result
+		 * @param node	The requesting node
+		 * @param message	The request
+		 */
+		void serve(int node, const std::vector<char>& message) {
+			request_header header;
+			std::memcpy(&header, message.data(), sizeof(header));
+			std::pair<void (*)(), home_function> function;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				function = _functions.at(header.function);
+			}
+			std::vector<char> reply(sizeof(reply_header) + header.result_size);
+			reply_header result{header.sequence, 0};
+			try {
+				function.second(function.first, _backing + header.local,
+						message.data() + sizeof(header), reply.data() + sizeof(reply_header));
+			} catch(...) {
+				result.failed = 1;
+			}
+			std::memcpy(reply.data(), &result, sizeof(result));
+			send(std::move(reply), node, reply_tag);
+		}
+
+		/**
+		 * @brief	Hands a result to the continuation of its request
+		 * @param message	The reply
+		 */
+		void complete(const std::vector<char>& message) {
+			reply_header header;
+			std::memcpy(&header, message.data(), sizeof(header));
+			continuation done;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				auto it = _waiting.find(header.sequence);
+				done = std::move(it->second);
+				_waiting.erase(it);
+			}
+			done(header.failed ? nullptr : message.data() + sizeof(header));
+			std::lock_guard<std::mutex> lock(_mutex);
+			_completed.notify_all();
+		}
+
+		/** @brief Receives and handles messages until stopped */
+		void run() {
+			std::vector<char> message;
+			while(true) {
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					if(_stop) {
+						return;
+					}
+				}
+				complete_sends();
+				int arrived;
+				MPI_Status status;
+				sem_wait(_mpi_lock);
+				MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, _comm, &arrived, &status);
+				if(arrived) {
+					int count;
+					MPI_Get_count(&status, MPI_BYTE, &count);
+					message.resize(count);
+					MPI_Recv(message.data(), count, MPI_BYTE, status.MPI_SOURCE, status.MPI_TAG,
+							_comm, MPI_STATUS_IGNORE);
+				}
+				sem_post(_mpi_lock);
+				if(!arrived) {
+					std::this_thread::sleep_for(std::chrono::microseconds(20));
+				} else if(status.MPI_TAG == request_tag) {
+					serve(status.MPI_SOURCE, message);
+				} else {
+					complete(message);
+				}
+			}
+		}
+
+	public:
+		/**
+		 * @brief	Constructs the service without starting its thread
+		 * @param comm	The communicator of all nodes, which is duplicated
+		 *		for the messages of the service
+		 * @param mpi_lock	The lock serializing all MPI calls
+		 * @param backing	The backing memory of the objects homed on this node
+		 * @note	Collective over all nodes.
+		 */
+		home_service(MPI_Comm comm, sem_t* mpi_lock, char* backing)
+			: _mpi_lock(mpi_lock), _backing(backing), _sequence(0),
+			  _stop(false), _running(false) {
+			sem_wait(_mpi_lock);
+			MPI_Comm_dup(comm, &_comm);
+			sem_post(_mpi_lock);
+		}
+
+		/**
+		 * @brief	Completes the requests of all nodes and stops the service thread
+		 * @note	Collective over all nodes, whether or not they started
+		 *		the service thread.
+		 */
+		~home_service() {
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_completed.wait(lock, [this]{ return _waiting.empty(); });
+			}
+			/* once all nodes got their replies, no more requests can arrive */
+			MPI_Request barrier;
+			sem_wait(_mpi_lock);
+			MPI_Ibarrier(_comm, &barrier);
+			sem_post(_mpi_lock);
+			for(int done = 0; !done;) {
+				std::this_thread::sleep_for(std::chrono::microseconds(20));
+				sem_wait(_mpi_lock);
+				MPI_Test(&barrier, &done, MPI_STATUS_IGNORE);
+				sem_post(_mpi_lock);
+			}
+			if(_running) {
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					_stop = true;
+				}
+				_thread.join();
+			}
+			for(auto& s : _sends) {
+				MPI_Wait(&s.request, MPI_STATUS_IGNORE);
+			}
+			MPI_Comm_free(&_comm);
+		}
+
+		/** @brief Copy constructor is not allowed */
+		home_service(const home_service&) = delete;
+		/** @brief Copy assignment is not allowed */
+		home_service& operator=(const home_service&) = delete;
+
+		/**
+		 * @brief	Checks whether the service thread is started
+		 * @return	true once a function has been registered
+		 */
+		bool running() const {
+			return _running;
+		}
+
+		/**
+		 * @brief	Registers a function to run at home nodes
+		 * @param fn	The function
+		 * @param call	Calls the function on the backing memory
+		 * @note	Functions must be registered in the same order on all nodes.
+		 *		Registering a function again has no effect. The first
+		 *		registration starts the service thread of this node.
+		 */
+		void register_function(void (*fn)(), home_function call) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			if(_function_index.count(fn) == 0) {
+				_function_index[fn] = _functions.size();
+				_functions.emplace_back(fn, call);
+			}
+			if(!_running) {
+				_thread = std::thread(&home_service::run, this);
+				_running = true;
+			}
+		}
+
+		/**
+		 * @brief	Requests to run a function at the home node of an object
+		 * @param node	The home node of the object
+		 * @param local	The offset of the object in the backing memory of the home node
+		 * @param fn	The registered function
+		 * @param arg	The argument of the function
+		 * @param arg_size	The size of the argument in bytes
+		 * @param result_size	The size of the result in bytes
+		 * @param done	Called by the service thread with the result, or
+		 *		with nullptr if the function threw
+		 * @throws std::invalid_argument if fn is not registered
+		 */
+		void invoke(int node, std::size_t local, void (*fn)(), const void* arg,
+				std::size_t arg_size, std::size_t result_size, continuation done) {
+			request_header header{0, 0, local, result_size};
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				auto it = _function_index.find(fn);
+				if(it == _function_index.end()) {
+					throw std::invalid_argument("The function must be registered before it is invoked");
+				}
+				header.function = it->second;
+				header.sequence = _sequence++;
+				_waiting[header.sequence] = std::move(done);
+			}
+			std::vector<char> message(sizeof(header) + arg_size);
+			std::memcpy(message.data(), &header, sizeof(header));
+			std::memcpy(message.data() + sizeof(header), arg, arg_size);
+			send(std::move(message), node, request_tag);
+		}
+};
+
+#endif /* argo_home_service_hpp */
@@ -8,6 +8,8 @@
 
 #include <atomic>
 #include <algorithm>
+#include <deque>
+#include <limits>
 #include <type_traits>
 #include <mpi.h>
 
@@ -27,6 +29,13 @@ extern MPI_Comm workcomm;
  * @see swdsm.cpp
  */
 extern MPI_Win  *globalDataWindow;
+/**
+ * @brief MPI window for atomic operations on the global memory
+ * @details All nodes keep a shared access epoch open on this window,
+ *          so atomic operations only need to be flushed.
+ * @see swdsm.cpp
+ */
+extern MPI_Win atomicWindow;
 
 /**
  * @brief MPI window for the first-touch data distribution
@@ -53,6 +62,19 @@ extern std::uintptr_t *global_owners_dir;
  */
 extern std::uintptr_t *global_offsets_tbl;
 
+/**
+ * @brief MPI window for the lock buffer
+ * @see swdsm.cpp
+ * @see global_mcs_lock.hpp
+ */
+extern MPI_Win lockWindow;
+/**
+ * @brief Local lock buffer, exposed through lockWindow
+ * @see swdsm.cpp
+ * @see global_mcs_lock.hpp
+ */
+extern unsigned long *lockbuffer;
+
 /**
  * @todo should be changed to qd-locking (but need to be replaced in the other files as well)
  *       or removed when infiniband/the mpi implementations allows for multithreaded accesses to the interconnect
@@ -154,6 +176,78 @@ static MPI_Datatype fitting_mpi_float(std::size_t size) {
 	return t_type;
 }
 
+/**
+ * @brief Returns the MPI operation matching a reduction operation
+ *
+ * @param op The reduction operation
+ * @return The MPI operation
+ */
+static MPI_Op fitting_mpi_op(argo::reduction_op op) {
+	using argo::reduction_op;
+
+	switch (op) {
+	case reduction_op::sum:
+		return MPI_SUM;
+	case reduction_op::min:
+		return MPI_MIN;
+	case reduction_op::max:
+		return MPI_MAX;
+	case reduction_op::bitwise_and:
+		return MPI_BAND;
+	case reduction_op::bitwise_or:
+		return MPI_BOR;
+	case reduction_op::bitwise_xor:
+		return MPI_BXOR;
+	}
+	throw std::invalid_argument("Invalid reduction operation");
+}
+
+/**
+ * @brief Returns the MPI operation matching a reduction operation on floating point numbers
+ *
+ * @param op The reduction operation, which must not be a bitwise one
+ * @return The MPI operation
+ */
+static MPI_Op fitting_mpi_float_op(argo::reduction_op op) {
+	using argo::reduction_op;
+
+	if (op != reduction_op::sum && op != reduction_op::min && op != reduction_op::max) {
+		throw std::invalid_argument(
+			"Bitwise operations are only defined for integer types");
+	}
+	return fitting_mpi_op(op);
+}
+
+/**
+ * @brief Origin buffer of a non-blocking atomic operation
+ * @details MPI may read the origin buffer of an accumulate operation until
+ *          the operation is flushed, so values are kept here until then.
+ */
+struct pending_value {
+	/** @brief space for the largest supported value */
+	alignas(16) char data[16];
+};
+
+/**
+ * @brief Values of the non-blocking atomic operations not yet flushed
+ * @note protected by ibsem, and a deque as growing it must not move the buffers
+ */
+static std::deque<pending_value> pending_ops;
+
+/** @brief Number of pending non-blocking atomic operations that triggers a flush */
+static const std::size_t max_pending_ops = 4096;
+
+/**
+ * @brief Complete the pending non-blocking atomic operations
+ * @note ibsem must be held by the caller
+ */
+static void flush_pending_ops() {
+	if (!pending_ops.empty()) {
+		MPI_Win_flush_all(atomicWindow);
+		pending_ops.clear();
+	}
+}
+
 namespace argo {
 	namespace backend {
 		void init(std::size_t argo_size, std::size_t cache_size){
@@ -181,16 +275,83 @@ namespace argo {
 		}
 
 		void barrier(std::size_t tc) {
+			atomic::_flush_ops();
 			swdsm_argo_barrier(tc);
 		}
 
+		void _allreduce_int(void* value, reduction_op op, std::size_t size, std::size_t threadcount) {
+			atomic::_flush_ops();
+			swdsm_argo_allreduce(value, fitting_mpi_int(size), fitting_mpi_op(op), threadcount);
+		}
+
+		void _allreduce_uint(void* value, reduction_op op, std::size_t size, std::size_t threadcount) {
+			atomic::_flush_ops();
+			swdsm_argo_allreduce(value, fitting_mpi_uint(size), fitting_mpi_op(op), threadcount);
+		}
+
+		void _allreduce_float(void* value, reduction_op op, std::size_t size, std::size_t threadcount) {
+			atomic::_flush_ops();
+			swdsm_argo_allreduce(value, fitting_mpi_float(size), fitting_mpi_float_op(op), threadcount);
+		}
+
+		void _reduce_int(void* value, reduction_op op, std::size_t size, node_id_t root,
+				std::size_t threadcount) {
+			swdsm_argo_reduce(value, fitting_mpi_int(size), fitting_mpi_op(op), root, threadcount);
+		}
+
+		void _reduce_uint(void* value, reduction_op op, std::size_t size, node_id_t root,
+				std::size_t threadcount) {
+			swdsm_argo_reduce(value, fitting_mpi_uint(size), fitting_mpi_op(op), root, threadcount);
+		}
+
+		void _reduce_float(void* value, reduction_op op, std::size_t size, node_id_t root,
+				std::size_t threadcount) {
+			swdsm_argo_reduce(value, fitting_mpi_float(size), fitting_mpi_float_op(op), root, threadcount);
+		}
+
 		template<typename T>
 		void broadcast(node_id_t source, T* ptr) {
+			MPI_Request request;
 			sem_wait(&ibsem);
-			MPI_Bcast(static_cast<void*>(ptr), sizeof(T), MPI_BYTE, source, workcomm);
+			MPI_Ibcast(static_cast<void*>(ptr), sizeof(T), MPI_BYTE, source, workcomm, &request);
+			argo_complete_collective(&request);
 			sem_post(&ibsem);
 		}
 
+		void register_function(void (*fn)(), home_function call) {
+			argo_register_home_function(fn, call);
+		}
+
+		void invoke_at_home(void* object, std::size_t object_size, void (*fn)(),
+				const void* arg, std::size_t arg_size, std::size_t result_size,
+				std::function<void(const void*)> done) {
+			argo_invoke_at_home(object, object_size, fn, arg, arg_size, result_size, std::move(done));
+		}
+
+		ticket prefetch(void* addr, std::size_t size) {
+			return argo_prefetch_async(addr, size);
+		}
+
+		void advise(void* addr, std::size_t size, advice hints) {
+			argo_set_advice(addr, size, hints);
+		}
+
+		bool _is_cached(const void* addr) {
+			return argo_is_cached(addr);
+		}
+
+		bool _is_sharer(const void* addr, node_id_t node) {
+			return argo_is_sharer(addr, node);
+		}
+
+		void wait(ticket t) {
+			argo_async_wait(t);
+		}
+
+		bool test(ticket t) {
+			return argo_async_test(t);
+		}
+
 		void acquire() {
 			argo_acquire();
 			std::atomic_thread_fence(std::memory_order_acquire);
@@ -198,6 +359,13 @@ namespace argo {
 		void release() {
 			std::atomic_thread_fence(std::memory_order_release);
 			argo_release();
+			atomic::_flush_ops();
+		}
+
+		ticket release_async() {
+			std::atomic_thread_fence(std::memory_order_release);
+			atomic::_flush_ops();
+			return argo_submit_release();
 		}
 
 #include "../explicit_instantiations.inc.cpp"
@@ -208,9 +376,8 @@ namespace argo {
 				sem_wait(&ibsem);
 				MPI_Datatype t_type = fitting_mpi_int(size);
 				// Perform the exchange operation
-				MPI_Win_lock(MPI_LOCK_EXCLUSIVE, obj.node(), 0, globalDataWindow[0]);
-				MPI_Fetch_and_op(desired, output_buffer, t_type, obj.node(), obj.offset(), MPI_REPLACE, globalDataWindow[0]);
-				MPI_Win_unlock(obj.node(), globalDataWindow[0]);
+				MPI_Fetch_and_op(desired, output_buffer, t_type, obj.node(), obj.offset(), MPI_REPLACE, atomicWindow);
+				MPI_Win_flush(obj.node(), atomicWindow);
 				// Cleanup
 				sem_post(&ibsem);
 			}
@@ -218,10 +385,9 @@ namespace argo {
 			void _store(global_ptr<void> obj, void* desired, std::size_t size) {
 				sem_wait(&ibsem);
 				MPI_Datatype t_type = fitting_mpi_int(size);
-				// Perform the store operation
-				MPI_Win_lock(MPI_LOCK_EXCLUSIVE, obj.node(), 0, globalDataWindow[0]);
-				MPI_Put(desired, 1, t_type, obj.node(), obj.offset(), 1, t_type, globalDataWindow[0]);
-				MPI_Win_unlock(obj.node(), globalDataWindow[0]);
+				// Perform the store operation, atomically with respect to other atomics
+				MPI_Accumulate(desired, 1, t_type, obj.node(), obj.offset(), 1, t_type, MPI_REPLACE, atomicWindow);
+				MPI_Win_flush(obj.node(), atomicWindow);
 				// Cleanup
 				sem_post(&ibsem);
 			}
@@ -251,14 +417,27 @@ namespace argo {
 				MPI_Win_unlock(rank, offsets_tbl_window);
 			}
 
+			void _store_lockbuffer(const std::size_t desired,
+					const node_id_t rank, const std::size_t disp) {
+				static_assert(lockbuffer_words * sizeof(std::size_t) <= page_size,
+					"The lock buffer must fit into one page");
+				sem_wait(&ibsem);
+				MPI_Datatype t_type = fitting_mpi_uint(sizeof(std::size_t));
+				// Perform the store operation
+				MPI_Win_lock(MPI_LOCK_EXCLUSIVE, rank, 0, lockWindow);
+				MPI_Put(&desired, 1, t_type, rank, disp*sizeof(std::size_t), 1, t_type, lockWindow);
+				MPI_Win_unlock(rank, lockWindow);
+				// Cleanup
+				sem_post(&ibsem);
+			}
+
 			void _load(global_ptr<void> obj, std::size_t size,
 					void* output_buffer) {
 				sem_wait(&ibsem);
 				MPI_Datatype t_type = fitting_mpi_int(size);
-				// Perform the store operation
-				MPI_Win_lock(MPI_LOCK_SHARED, obj.node(), 0, globalDataWindow[0]);
-				MPI_Get(output_buffer, 1, t_type, obj.node(), obj.offset(), 1, t_type, globalDataWindow[0]);
-				MPI_Win_unlock(obj.node(), globalDataWindow[0]);
+				// Perform the load operation, atomically with respect to other atomics
+				MPI_Fetch_and_op(nullptr, output_buffer, t_type, obj.node(), obj.offset(), MPI_NO_OP, atomicWindow);
+				MPI_Win_flush(obj.node(), atomicWindow);
 				// Cleanup
 				sem_post(&ibsem);
 			}
@@ -288,14 +467,28 @@ namespace argo {
 				MPI_Win_unlock(rank, offsets_tbl_window);
 			}
 
+			void _load_local_lockbuffer(std::size_t* output_buffer,
+					const std::size_t disp) {
+				sem_wait(&ibsem);
+				// Perform the load operation
+				MPI_Win_lock(MPI_LOCK_SHARED, argo_get_nid(), 0, lockWindow);
+				*output_buffer = lockbuffer[disp];
+				MPI_Win_unlock(argo_get_nid(), lockWindow);
+				// Cleanup
+				sem_post(&ibsem);
+			}
+
+			const volatile std::size_t* _local_lockbuffer_word(const std::size_t disp) {
+				return reinterpret_cast<const volatile std::size_t*>(&lockbuffer[disp]);
+			}
+
 			void _compare_exchange(global_ptr<void> obj, void* desired,
 					std::size_t size, void* expected, void* output_buffer) {
 				sem_wait(&ibsem);
 				MPI_Datatype t_type = fitting_mpi_int(size);
-				// Perform the store operation
-				MPI_Win_lock(MPI_LOCK_EXCLUSIVE, obj.node(), 0, globalDataWindow[0]);
-				MPI_Compare_and_swap(desired, expected, output_buffer, t_type, obj.node(), obj.offset(), globalDataWindow[0]);
-				MPI_Win_unlock(obj.node(), globalDataWindow[0]);
+				// Perform the compare-and-swap operation
+				MPI_Compare_and_swap(desired, expected, output_buffer, t_type, obj.node(), obj.offset(), atomicWindow);
+				MPI_Win_flush(obj.node(), atomicWindow);
 				// Cleanup
 				sem_post(&ibsem);
 			}
@@ -334,10 +527,9 @@ namespace argo {
 			void _fetch_add(global_ptr<void> obj, void* value,
 					MPI_Datatype t_type, void* output_buffer) {
 				sem_wait(&ibsem);
-				// Perform the exchange operation
-				MPI_Win_lock(MPI_LOCK_EXCLUSIVE, obj.node(), 0, globalDataWindow[0]);
-				MPI_Fetch_and_op(value, output_buffer, t_type, obj.node(), obj.offset(), MPI_SUM, globalDataWindow[0]);
-				MPI_Win_unlock(obj.node(), globalDataWindow[0]);
+				// Perform the fetch&add operation
+				MPI_Fetch_and_op(value, output_buffer, t_type, obj.node(), obj.offset(), MPI_SUM, atomicWindow);
+				MPI_Win_flush(obj.node(), atomicWindow);
 				// Cleanup
 				sem_post(&ibsem);
 			}
@@ -359,6 +551,175 @@ namespace argo {
 				MPI_Datatype t_type = fitting_mpi_float(size);
 				_fetch_add(obj, value, t_type, output_buffer);
 			}
+
+			/**
+			 * @brief Atomic fetch&op for the MPI backend (for internal usage)
+			 *
+			 * @param obj The pointer to the memory location to modify
+			 * @param value Pointer to the value to combine with
+			 * @param t_type MPI type of the object, value, and output buffer
+			 * @param op MPI operation to apply
+			 * @param output_buffer Location to store the return value
+			 */
+			void _fetch_op(global_ptr<void> obj, void* value,
+					MPI_Datatype t_type, MPI_Op op, void* output_buffer) {
+				sem_wait(&ibsem);
+				MPI_Fetch_and_op(value, output_buffer, t_type, obj.node(), obj.offset(), op, atomicWindow);
+				MPI_Win_flush(obj.node(), atomicWindow);
+				sem_post(&ibsem);
+			}
+
+			void _fetch_op_int(global_ptr<void> obj, reduction_op op, void* value,
+					std::size_t size, void* output_buffer) {
+				_fetch_op(obj, value, fitting_mpi_int(size), fitting_mpi_op(op), output_buffer);
+			}
+
+			void _fetch_op_uint(global_ptr<void> obj, reduction_op op, void* value,
+					std::size_t size, void* output_buffer) {
+				_fetch_op(obj, value, fitting_mpi_uint(size), fitting_mpi_op(op), output_buffer);
+			}
+
+			void _fetch_op_float(global_ptr<void> obj, reduction_op op, void* value,
+					std::size_t size, void* output_buffer) {
+				_fetch_op(obj, value, fitting_mpi_float(size), fitting_mpi_float_op(op), output_buffer);
+			}
+
+			/**
+			 * @brief Non-blocking atomic operation for the MPI backend (for internal usage)
+			 *
+			 * @param obj The pointer to the memory location to modify
+			 * @param value Pointer to the value to combine with
+			 * @param size Size of the value
+			 * @param t_type MPI type of the object and value
+			 * @param op MPI operation to apply
+			 */
+			void _post_op(global_ptr<void> obj, const void* value, std::size_t size,
+					MPI_Datatype t_type, MPI_Op op) {
+				sem_wait(&ibsem);
+				pending_ops.emplace_back();
+				char* origin = pending_ops.back().data;
+				std::copy_n(static_cast<const char*>(value), size, origin);
+				MPI_Accumulate(origin, 1, t_type, obj.node(), obj.offset(), 1, t_type, op, atomicWindow);
+				if (pending_ops.size() >= max_pending_ops) {
+					flush_pending_ops();
+				}
+				sem_post(&ibsem);
+			}
+
+			void _post_op_int(global_ptr<void> obj, reduction_op op, const void* value,
+					std::size_t size) {
+				_post_op(obj, value, size, fitting_mpi_int(size), fitting_mpi_op(op));
+			}
+
+			void _post_op_uint(global_ptr<void> obj, reduction_op op, const void* value,
+					std::size_t size) {
+				_post_op(obj, value, size, fitting_mpi_uint(size), fitting_mpi_op(op));
+			}
+
+			void _post_op_float(global_ptr<void> obj, reduction_op op, const void* value,
+					std::size_t size) {
+				_post_op(obj, value, size, fitting_mpi_float(size), fitting_mpi_float_op(op));
+			}
+
+			void _flush_ops() {
+				sem_wait(&ibsem);
+				flush_pending_ops();
+				sem_post(&ibsem);
+			}
+
+			/**
+			 * @brief Batched atomic fetch&add for the MPI backend (for internal usage)
+			 *
+			 * All operations are issued before a single flush, so they
+			 * share one round trip to each target.
+			 *
+			 * @param objs The pointers to the memory locations to modify
+			 * @param values The values to add, one per object
+			 * @param count The number of objects
+			 * @param t_type MPI type of the objects, values, and output buffer
+			 * @param output_buffer Location to store the old values, one per object
+			 */
+			void _fetch_add_many(const global_ptr<void>* objs, const void* values,
+					std::size_t count, MPI_Datatype t_type, void* output_buffer) {
+				int size;
+				MPI_Type_size(t_type, &size);
+				const char* value = static_cast<const char*>(values);
+				char* output = static_cast<char*>(output_buffer);
+				sem_wait(&ibsem);
+				for(std::size_t i = 0; i < count; i++) {
+					MPI_Fetch_and_op(value + i*size, output + i*size, t_type,
+							objs[i].node(), objs[i].offset(), MPI_SUM, atomicWindow);
+				}
+				MPI_Win_flush_all(atomicWindow);
+				sem_post(&ibsem);
+			}
+
+			/**
+			 * @brief Range accumulate for the MPI backend (for internal usage)
+			 *
+			 * @param segments Pointers to the first element of each segment
+			 * @param counts The number of elements in each segment
+			 * @param num_segments The number of segments
+			 * @param values The values to combine the elements with
+			 * @param t_type MPI type of the elements and values
+			 * @param op MPI operation to apply
+			 */
+			void _accumulate(const global_ptr<void>* segments, const std::size_t* counts,
+					std::size_t num_segments, const void* values, MPI_Datatype t_type, MPI_Op op) {
+				int size;
+				MPI_Type_size(t_type, &size);
+				const std::size_t max_count = std::numeric_limits<int>::max();
+				const char* value = static_cast<const char*>(values);
+				/* the update bypasses the caches, which must learn about it */
+				for(std::size_t i = 0; i < num_segments; i++) {
+					argo_prepare_remote_write(segments[i].get(), counts[i]*size);
+				}
+				sem_wait(&ibsem);
+				for(std::size_t i = 0; i < num_segments; i++) {
+					/* MPI counts are ints, so huge segments are issued in parts */
+					for(std::size_t done = 0; done < counts[i]; done += max_count) {
+						int count = static_cast<int>(std::min(counts[i] - done, max_count));
+						MPI_Accumulate(value, count, t_type, segments[i].node(),
+								segments[i].offset() + done*size, count, t_type, op, atomicWindow);
+						value += count*size;
+					}
+				}
+				MPI_Win_flush_all(atomicWindow);
+				sem_post(&ibsem);
+			}
+
+			void _accumulate_int(const global_ptr<void>* segments, const std::size_t* counts,
+					std::size_t num_segments, const void* values, reduction_op op, std::size_t size) {
+				_accumulate(segments, counts, num_segments, values, fitting_mpi_int(size), fitting_mpi_op(op));
+			}
+
+			void _accumulate_uint(const global_ptr<void>* segments, const std::size_t* counts,
+					std::size_t num_segments, const void* values, reduction_op op, std::size_t size) {
+				_accumulate(segments, counts, num_segments, values, fitting_mpi_uint(size), fitting_mpi_op(op));
+			}
+
+			void _accumulate_float(const global_ptr<void>* segments, const std::size_t* counts,
+					std::size_t num_segments, const void* values, reduction_op op, std::size_t size) {
+				_accumulate(segments, counts, num_segments, values, fitting_mpi_float(size), fitting_mpi_float_op(op));
+			}
+
+			void _fetch_add_many_int(const global_ptr<void>* objs, const void* values,
+					std::size_t count, std::size_t size, void* output_buffer) {
+				MPI_Datatype t_type = fitting_mpi_int(size);
+				_fetch_add_many(objs, values, count, t_type, output_buffer);
+			}
+
+			void _fetch_add_many_uint(const global_ptr<void>* objs, const void* values,
+					std::size_t count, std::size_t size, void* output_buffer) {
+				MPI_Datatype t_type = fitting_mpi_uint(size);
+				_fetch_add_many(objs, values, count, t_type, output_buffer);
+			}
+
+			void _fetch_add_many_float(const global_ptr<void>* objs, const void* values,
+					std::size_t count, std::size_t size, void* output_buffer) {
+				MPI_Datatype t_type = fitting_mpi_float(size);
+				_fetch_add_many(objs, values, count, t_type, output_buffer);
+			}
 		} // namespace atomic
 	} // namespace backend
 } // namespace argo
@@ -0,0 +1,522 @@
+/**
+ * @file
+ * @brief This file implements bulk transfers that bypass the ArgoDSM cache
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "../backend.hpp"
+#include "env/env.hpp"
+#include "swdsm.h"
+#include "virtual_memory/virtual_memory.hpp"
+
+// EXTERNAL VARIABLES FROM BACKEND
+/**
+ * @brief This is needed to access page information from the cache
+ * @deprecated Should be replaced with a cache API
+ */
+extern control_data *cacheControl;
+/**
+ * @brief A cache mutex protects all operations on cacheControl
+ * @deprecated Should eventually be handled by a cache module
+ */
+extern pthread_mutex_t cachemutex;
+/**
+ * @brief ibsem is used to serialize all Infiniband (MPI) operations
+ * @deprecated Should not be needed once the cache module is implemented
+ */
+extern sem_t ibsem;
+/**
+ * @brief The transfers are issued in the passive epoch of the atomic window
+ */
+extern MPI_Win atomicWindow;
+/**
+ * @brief The backing memory of the lines homed on this node
+ */
+extern char* globalData;
+
+namespace {
+	/** @brief size of an ArgoDSM cache line */
+	const std::size_t block_size = page_size*CACHELINE;
+
+	/** @brief the home of a cache line */
+	struct line_home {
+		/** @brief the home node */
+		std::size_t node;
+		/** @brief the offset of the line on the home node */
+		std::size_t offset;
+	};
+
+	/** @brief a part of a transfer that is contiguous on its home node */
+	struct home_run {
+		/** @brief the home node */
+		std::size_t node;
+		/** @brief the offset of the part on the home node */
+		std::size_t offset;
+		/** @brief the part of the local buffer */
+		char* local;
+		/** @brief the size of the part in bytes */
+		std::size_t size;
+	};
+
+	/**
+	 * @brief check that a local buffer is not part of the global memory
+	 * @param buffer the local buffer
+	 * @param size the size of the buffer in bytes
+	 * @throws std::invalid_argument if the buffer overlaps the global memory
+	 */
+	void check_local(const void* buffer, std::size_t size) {
+		const char* start = static_cast<const char*>(argo::virtual_memory::start_address());
+		const char* b = static_cast<const char*>(buffer);
+		if(b < start + argo::virtual_memory::size() && b + size > start) {
+			throw std::invalid_argument("The local buffer must not be in the global memory");
+		}
+	}
+
+	/**
+	 * @brief check that a range is part of the global memory
+	 * @param range the start of the range
+	 * @param size the size of the range in bytes
+	 * @throws std::invalid_argument if the range is not inside the global memory
+	 */
+	void check_global(const void* range, std::size_t size) {
+		const char* start = argo::backend::global_base();
+		const std::size_t global_size = argo::backend::global_size();
+		const char* r = static_cast<const char*>(range);
+		if(r < start || static_cast<std::size_t>(r - start) > global_size ||
+				size > global_size - static_cast<std::size_t>(r - start)) {
+			throw std::invalid_argument("The range must be in the global memory");
+		}
+	}
+
+	/**
+	 * @brief find the home of the cache lines of a range
+	 * @param start the offset of the range in the global memory
+	 * @param end the offset of the end of the range
+	 * @return the home of each cache line overlapping the range
+	 * @note must not be called with ibsem held, as a first-touch lookup
+	 *       may need to communicate
+	 */
+	std::vector<line_home> find_homes(std::size_t start, std::size_t end) {
+		std::vector<line_home> homes;
+		for(std::size_t line = start / block_size * block_size; line < end; line += block_size) {
+			homes.push_back({getHomenode(line, argo::env::allocation_policy()),
+					getOffset(line, argo::env::allocation_policy())});
+		}
+		return homes;
+	}
+
+	/**
+	 * @brief issue the transfer of a run
+	 * @param run the run to transfer
+	 * @param put true to write the local buffer to the home node,
+	 *            false to read from the home node into the local buffer
+	 * @note ibsem must be held by the caller
+	 */
+	void transfer(const home_run& run, bool put) {
+		const std::size_t max_count = std::numeric_limits<int>::max();
+		for(std::size_t done = 0; done < run.size; done += max_count) {
+			int count = static_cast<int>(std::min(run.size - done, max_count));
+			if(put) {
+				MPI_Put(run.local + done, count, MPI_BYTE, run.node, run.offset + done,
+						count, MPI_BYTE, atomicWindow);
+			} else {
+				MPI_Get(run.local + done, count, MPI_BYTE, run.node, run.offset + done,
+						count, MPI_BYTE, atomicWindow);
+			}
+		}
+	}
+
+	/**
+	 * @brief transfer a range between a local buffer and the home nodes
+	 * @param global the range in the global memory
+	 * @param local the local buffer
+	 * @param size the size of the range in bytes
+	 * @param put the direction of the transfer, see transfer()
+	 * @param use_cache if true, lines valid in the cache are copied from
+	 *                  there instead of the home node
+	 * @note ibsem and, if use_cache is set, cachemutex must be held
+	 */
+	void transfer_range(char* global, char* local, std::size_t size, bool put, bool use_cache,
+			const std::vector<line_home>& homes) {
+		char* const base = static_cast<char*>(argo::virtual_memory::start_address());
+		const std::size_t start = global - base;
+		const std::size_t end = start + size;
+		const std::size_t me = argo::backend::node_id();
+		home_run run{0, 0, nullptr, 0};
+		std::size_t line = start / block_size * block_size;
+		for(std::size_t i = 0; line < end; i++, line += block_size) {
+			const std::size_t lo = std::max(start, line);
+			const std::size_t hi = std::min(end, line + block_size);
+			char* part = local + (lo - start);
+			const std::size_t index = getCacheIndex(line);
+			if(use_cache && homes[i].node != me && cacheControl[index].tag == line &&
+					cacheControl[index].state != INVALID) {
+				std::memcpy(part, base + lo, hi - lo);
+				continue;
+			}
+			const std::size_t offset = homes[i].offset + (lo - line);
+			if(run.size > 0 && run.node == homes[i].node && run.offset + run.size == offset &&
+					run.local + run.size == part) {
+				run.size += hi - lo;
+			} else {
+				transfer(run, put);
+				run = {homes[i].node, offset, part, hi - lo};
+			}
+		}
+		transfer(run, put);
+		MPI_Win_flush_all(atomicWindow);
+	}
+
+	/** @brief the elements of a gather or scatter on one home node */
+	struct home_elements {
+		/** @brief the displacements of the elements in the local buffer */
+		std::vector<MPI_Aint> local;
+		/** @brief the offsets of the elements on the home node */
+		std::vector<MPI_Aint> remote;
+	};
+
+	/**
+	 * @brief find the home of each element of a gather or scatter
+	 * @param base the global address the offsets are relative to
+	 * @param offsets the offsets of the elements in bytes
+	 * @param count the number of elements
+	 * @param size the size of an element in bytes
+	 * @param lines filled with the home of each cache line holding an element
+	 * @return the cache line holding each element
+	 * @throws std::invalid_argument if an element is not inside the global
+	 *         memory or crosses a cache line boundary
+	 * @note must not be called with ibsem held, see find_homes()
+	 */
+	std::vector<std::size_t> find_element_homes(char* base, const std::ptrdiff_t* offsets,
+			std::size_t count, std::size_t size,
+			std::unordered_map<std::size_t, line_home>& lines) {
+		char* const start = static_cast<char*>(argo::virtual_memory::start_address());
+		std::vector<std::size_t> element_lines(count);
+		for(std::size_t i = 0; i < count; i++) {
+			check_global(base + offsets[i], size);
+			const std::size_t addr = base + offsets[i] - start;
+			const std::size_t line = addr / block_size * block_size;
+			if((addr + size - 1) / block_size * block_size != line) {
+				throw std::invalid_argument("Elements must not cross cache line boundaries");
+			}
+			element_lines[i] = line;
+			if(lines.find(line) == lines.end()) {
+				lines[line] = {getHomenode(line, argo::env::allocation_policy()),
+						getOffset(line, argo::env::allocation_policy())};
+			}
+		}
+		return element_lines;
+	}
+
+	/**
+	 * @brief transfer the elements of a gather or scatter on one home node
+	 * @param local the local buffer
+	 * @param node the home node
+	 * @param elements the elements on the home node
+	 * @param size the size of an element in bytes
+	 * @param put the direction of the transfer, see transfer()
+	 * @note ibsem must be held by the caller
+	 */
+	void transfer_elements(char* local, std::size_t node, const home_elements& elements,
+			std::size_t size, bool put) {
+		const std::size_t max_count = std::numeric_limits<int>::max();
+		for(std::size_t done = 0; done < elements.local.size(); done += max_count) {
+			int count = static_cast<int>(std::min(elements.local.size() - done, max_count));
+			MPI_Datatype origin, target;
+			MPI_Type_create_hindexed_block(count, size, elements.local.data() + done, MPI_BYTE, &origin);
+			MPI_Type_create_hindexed_block(count, size, elements.remote.data() + done, MPI_BYTE, &target);
+			MPI_Type_commit(&origin);
+			MPI_Type_commit(&target);
+			if(put) {
+				MPI_Put(local, 1, origin, node, 0, 1, target, atomicWindow);
+			} else {
+				MPI_Get(local, 1, origin, node, 0, 1, target, atomicWindow);
+			}
+			MPI_Type_free(&origin);
+			MPI_Type_free(&target);
+		}
+	}
+
+	/** @brief a part of a range that is homed on this node */
+	struct local_part {
+		/** @brief the offset of the part in the global memory */
+		std::size_t global;
+		/** @brief the offset of the part in the backing memory */
+		std::size_t local;
+		/** @brief the size of the part in bytes */
+		std::size_t size;
+	};
+
+	/**
+	 * @brief find the parts of a range that are homed on this node
+	 * @param start the offset of the range in the global memory
+	 * @param end the offset of the end of the range
+	 * @return the contiguous parts of the range homed on this node
+	 * @note must not be called with ibsem held, see find_homes()
+	 */
+	std::vector<local_part> find_local_parts(std::size_t start, std::size_t end) {
+		const std::size_t me = argo::backend::node_id();
+		std::vector<line_home> homes = find_homes(start, end);
+		std::vector<local_part> parts;
+		std::size_t line = start / block_size * block_size;
+		for(std::size_t i = 0; line < end; i++, line += block_size) {
+			if(homes[i].node != me) {
+				continue;
+			}
+			const std::size_t lo = std::max(start, line);
+			const std::size_t hi = std::min(end, line + block_size);
+			const std::size_t offset = homes[i].offset + (lo - line);
+			if(!parts.empty() && parts.back().global + parts.back().size == lo &&
+					parts.back().local + parts.back().size == offset) {
+				parts.back().size += hi - lo;
+			} else {
+				parts.push_back({lo, offset, hi - lo});
+			}
+		}
+		return parts;
+	}
+
+	/**
+	 * @brief make the other nodes drop their copies of the parts at their next acquire
+	 * @param parts the parts about to be updated in the backing memory
+	 */
+	void prepare_local_write(const std::vector<local_part>& parts) {
+		char* const start = static_cast<char*>(argo::virtual_memory::start_address());
+		for(auto& part : parts) {
+			argo_prepare_remote_write(start + part.global, part.size);
+		}
+	}
+
+	/**
+	 * @brief fill memory with a repeated pattern
+	 * @param dst the memory to fill
+	 * @param size the size of the memory in bytes
+	 * @param pattern the pattern
+	 * @param pattern_size the size of the pattern in bytes
+	 * @param phase the position in the pattern of the first byte
+	 */
+	void fill_pattern(char* dst, std::size_t size, const char* pattern,
+			std::size_t pattern_size, std::size_t phase) {
+		if(pattern_size == 1) {
+			std::memset(dst, *pattern, size);
+			return;
+		}
+		std::size_t filled = std::min(size, pattern_size);
+		for(std::size_t i = 0; i < filled; i++) {
+			dst[i] = pattern[(phase + i) % pattern_size];
+		}
+		/* filled is a multiple of the pattern size, so copying keeps the phase */
+		while(filled < size) {
+			const std::size_t n = std::min(filled, size - filled);
+			std::memcpy(dst + filled, dst, n);
+			filled += n;
+		}
+	}
+} // unnamed namespace
+
+namespace argo {
+	namespace backend {
+		void get(void* dst, const void* src, std::size_t size) {
+			if(size == 0) {
+				return;
+			}
+			check_local(dst, size);
+			check_global(src, size);
+			char* global = static_cast<char*>(const_cast<void*>(src));
+			const std::size_t start = global - static_cast<char*>(virtual_memory::start_address());
+			std::vector<line_home> homes = find_homes(start, start + size);
+			/* cached lines hold the latest data this node has seen, including its own writes */
+			pthread_mutex_lock(&cachemutex);
+			sem_wait(&ibsem);
+			transfer_range(global, static_cast<char*>(dst), size, false, true, homes);
+			sem_post(&ibsem);
+			pthread_mutex_unlock(&cachemutex);
+		}
+
+		void put(void* dst, const void* src, std::size_t size) {
+			if(size == 0) {
+				return;
+			}
+			check_local(src, size);
+			check_global(dst, size);
+			char* global = static_cast<char*>(dst);
+			const std::size_t start = global - static_cast<char*>(virtual_memory::start_address());
+			std::vector<line_home> homes = find_homes(start, start + size);
+			/* the data bypasses the caches, which must learn about it */
+			argo_prepare_remote_write(dst, size);
+			sem_wait(&ibsem);
+			transfer_range(global, static_cast<char*>(const_cast<void*>(src)), size, true, false, homes);
+			sem_post(&ibsem);
+		}
+
+		void gather(void* dst, const void* base, const std::ptrdiff_t* offsets,
+				std::size_t count, std::size_t size) {
+			if(count == 0) {
+				return;
+			}
+			check_local(dst, count * size);
+			char* global = static_cast<char*>(const_cast<void*>(base));
+			char* local = static_cast<char*>(dst);
+			std::unordered_map<std::size_t, line_home> lines;
+			std::vector<std::size_t> element_lines = find_element_homes(global, offsets, count, size, lines);
+
+			char* const start = static_cast<char*>(virtual_memory::start_address());
+			const std::size_t me = node_id();
+			std::map<std::size_t, home_elements> homes;
+			pthread_mutex_lock(&cachemutex);
+			sem_wait(&ibsem);
+			for(std::size_t i = 0; i < count; i++) {
+				const std::size_t line = element_lines[i];
+				const line_home& home = lines[line];
+				const std::size_t index = getCacheIndex(line);
+				/* cached lines hold the latest data this node has seen, including its own writes */
+				if(home.node != me && cacheControl[index].tag == line &&
+						cacheControl[index].state != INVALID) {
+					std::memcpy(local + i * size, global + offsets[i], size);
+					continue;
+				}
+				home_elements& elements = homes[home.node];
+				elements.local.push_back(i * size);
+				elements.remote.push_back(home.offset + (global + offsets[i] - start - line));
+			}
+			for(auto& elements : homes) {
+				transfer_elements(local, elements.first, elements.second, size, false);
+			}
+			MPI_Win_flush_all(atomicWindow);
+			sem_post(&ibsem);
+			pthread_mutex_unlock(&cachemutex);
+		}
+
+		void scatter(void* base, const void* src, const std::ptrdiff_t* offsets,
+				std::size_t count, std::size_t size) {
+			if(count == 0) {
+				return;
+			}
+			check_local(src, count * size);
+			char* global = static_cast<char*>(base);
+			char* local = static_cast<char*>(const_cast<void*>(src));
+			std::unordered_map<std::size_t, line_home> lines;
+			std::vector<std::size_t> element_lines = find_element_homes(global, offsets, count, size, lines);
+
+			/* the data bypasses the caches, which must learn about every touched line */
+			char* const start = static_cast<char*>(virtual_memory::start_address());
+			std::vector<std::size_t> touched;
+			for(auto& line : lines) {
+				touched.push_back(line.first);
+			}
+			std::sort(touched.begin(), touched.end());
+			for(std::size_t first = 0, last = 0; first < touched.size(); first = last) {
+				for(last = first + 1; last < touched.size() &&
+						touched[last] == touched[last - 1] + block_size; last++);
+				argo_prepare_remote_write(start + touched[first], touched[last - 1] + block_size - touched[first]);
+			}
+
+			std::map<std::size_t, home_elements> homes;
+			for(std::size_t i = 0; i < count; i++) {
+				const std::size_t line = element_lines[i];
+				const line_home& home = lines[line];
+				home_elements& elements = homes[home.node];
+				elements.local.push_back(i * size);
+				elements.remote.push_back(home.offset + (global + offsets[i] - start - line));
+			}
+			sem_wait(&ibsem);
+			for(auto& elements : homes) {
+				transfer_elements(local, elements.first, elements.second, size, true);
+			}
+			MPI_Win_flush_all(atomicWindow);
+			sem_post(&ibsem);
+		}
+
+		void fill(void* dst, const void* pattern, std::size_t pattern_size, std::size_t size) {
+			if(pattern_size == 0) {
+				throw std::invalid_argument("The fill pattern must not be empty");
+			}
+			char* global = static_cast<char*>(dst);
+			const std::size_t start = global - static_cast<char*>(virtual_memory::start_address());
+			std::vector<local_part> parts = find_local_parts(start, start + size);
+
+			/* all earlier writes must have reached the home nodes */
+			barrier(1);
+			prepare_local_write(parts);
+			for(auto& part : parts) {
+				fill_pattern(globalData + part.local, part.size, static_cast<const char*>(pattern),
+						pattern_size, (part.global - start) % pattern_size);
+			}
+			barrier(1);
+		}
+
+		void copy(void* dst, const void* src, std::size_t size) {
+			char* global_dst = static_cast<char*>(dst);
+			char* global_src = static_cast<char*>(const_cast<void*>(src));
+			if(global_dst < global_src + size && global_src < global_dst + size) {
+				throw std::invalid_argument("The ranges of a copy must not overlap");
+			}
+			char* const base = static_cast<char*>(virtual_memory::start_address());
+			const std::size_t start = global_dst - base;
+			std::vector<local_part> parts = find_local_parts(start, start + size);
+			std::vector<std::vector<line_home>> src_homes;
+			for(auto& part : parts) {
+				const std::size_t src_start = global_src - base + (part.global - start);
+				src_homes.push_back(find_homes(src_start, src_start + part.size));
+			}
+
+			/* all earlier writes must have reached the home nodes */
+			barrier(1);
+			prepare_local_write(parts);
+			sem_wait(&ibsem);
+			for(std::size_t i = 0; i < parts.size(); i++) {
+				transfer_range(global_src + (parts[i].global - start), globalData + parts[i].local,
+						parts[i].size, false, false, src_homes[i]);
+			}
+			sem_post(&ibsem);
+			barrier(1);
+		}
+
+		void broadcast_range(void* addr, std::size_t size, node_id_t root) {
+			if(root < 0 || root >= number_of_nodes()) {
+				throw std::invalid_argument("The root of a broadcast must be a node");
+			}
+			/* all earlier writes must have reached the home nodes */
+			barrier(1);
+			argo_broadcast_range(addr, size, root);
+		}
+
+		void* local_view(void* addr, std::size_t size, bool write) {
+			char* const base = static_cast<char*>(virtual_memory::start_address());
+			const std::size_t start = static_cast<char*>(addr) - base;
+			std::vector<local_part> parts = find_local_parts(start, start + size);
+			if(size == 0) {
+				return nullptr;
+			}
+			if(parts.size() != 1 || parts[0].size != size) {
+				throw std::invalid_argument(
+						"The range must be homed on this node, contiguously in its memory");
+			}
+			if(write) {
+				/* other nodes see writes through the view as writes of this node */
+				prepare_local_write(parts);
+			}
+			return globalData + parts[0].local;
+		}
+
+		ticket get_async(void* dst, const void* src, std::size_t size) {
+			check_local(dst, size);
+			check_global(src, size);
+			return argo_async_submit([=]{ get(dst, src, size); });
+		}
+
+		ticket put_async(void* dst, const void* src, std::size_t size) {
+			check_local(src, size);
+			check_global(dst, size);
+			return argo_async_submit([=]{ put(dst, src, size); });
+		}
+	} // namespace backend
+} // namespace argo
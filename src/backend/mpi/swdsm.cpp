@@ -3,14 +3,23 @@
  * @brief This file implements the MPI-backend of ArgoDSM
  * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
  */
+#include<atomic>
 #include<cstddef>
+#include<cstring>
+#include<vector>
 
 #include "env/env.hpp"
 #include "signal/signal.hpp"
+#include "topology/topology.hpp"
 #include "virtual_memory/virtual_memory.hpp"
 #include "data_distribution/global_ptr.hpp"
 #include "swdsm.h"
 #include "write_buffer.hpp"
+#include "async_worker.hpp"
+#include "home_service.hpp"
+#ifdef ARGO_USERFAULTFD
+#include "userfault.hpp"
+#endif
 
 namespace dd = argo::data_distribution;
 namespace vm = argo::virtual_memory;
@@ -33,6 +42,14 @@ pthread_mutex_t barriermutex = PTHREAD_MUTEX_INITIALIZER;
 /** @brief Thread local barrier used to first wait for all local threads in the global barrier*/
 pthread_barrier_t *threadbarrier;
 
+/*Reductions*/
+/** @brief Protects the combination of the local values of a reduction */
+pthread_mutex_t reductionmutex = PTHREAD_MUTEX_INITIALIZER;
+/** @brief Value of the ongoing reduction, large enough for any reduced type */
+alignas(16) char reductionvalue[16];
+/** @brief Number of local threads that have contributed to the ongoing reduction */
+int reductioncontributors = 0;
+
 
 /*Pagecache*/
 /** @brief  Size of the cache in number of pages*/
@@ -45,8 +62,20 @@ control_data * cacheControl;
 unsigned long *globalSharers;
 /** @brief  size of pyxis directory*/
 unsigned long classificationSize;
+/** @brief  Executes the asynchronous operations of this node, such as prefetches */
+async_worker* argo_async_worker;
+/** @brief  Runs the functions invoked on objects homed on this node */
+home_service* argo_home_service;
+#ifdef ARGO_USERFAULTFD
+/** @brief  Resolves the page faults of the global memory instead of the signal handler */
+userfault_service* argo_userfault;
+#endif
+/** @brief  The ticket of the last asynchronous release of this node */
+std::atomic<std::uint64_t> release_ticket(0);
 /** @brief  Tracks if a page is touched this epoch*/
 argo_byte * touchedcache;
+/** @brief  Access hints of each cache line of the global memory, see argo::advice */
+argo_byte * line_advice;
 /** @brief  The local page cache*/
 char* cacheData;
 /** @brief Copy of the local cache to keep twinpages for later being able to DIFF stores */
@@ -73,6 +102,8 @@ MPI_Win sharerWindow;
 MPI_Win lockWindow;
 /** @brief MPI windows for reading and writing data in global address space */
 MPI_Win *globalDataWindow;
+/** @brief MPI window for atomic operations in global address space, always in a shared epoch */
+MPI_Win atomicWindow;
 /** @brief MPI data structure for sending cache control data*/
 MPI_Datatype mpi_control_data;
 /** @brief MPI data structure for a block containing an ArgoDSM cacheline of pages */
@@ -201,7 +232,7 @@ void argo_pin_threads(){
   argo_register_thread();
   sem_wait(&ibsem);
   CPU_ZERO(&cpuset);
-  int pinto = argo_get_local_tid();
+  int pinto = argo::topology::cpu_for_thread(argo_get_local_tid());
   CPU_SET(pinto, &cpuset);
 
   s = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
@@ -248,15 +279,194 @@ inline std::size_t align_backwards(std::size_t offset, std::size_t size) {
 	return (offset / size) * size;
 }
 
-void handler(int sig, siginfo_t *si, void *unused){
-	UNUSED_PARAM(sig);
-	UNUSED_PARAM(unused);
+/** @brief lines sent by one collective operation of argo_broadcast_range */
+static const std::size_t broadcast_chunk_lines = 256;
+
+/** @brief lines prefetched ahead of a miss on a line advised as sequential */
+static const std::size_t sequential_prefetch_depth = 8;
+
+bool has_advice(std::size_t line_offset, argo::advice hints){
+	const argo::advice line = static_cast<argo::advice>(line_advice[line_offset/(pagesize*CACHELINE)]);
+	return (line & hints) != argo::advice::normal;
+}
+
+static void prefetch_range(void* addr, std::size_t size);
+
+/**
+ * @brief prefetches the lines following a miss on a sequential line
+ * @param line_offset offset of the missed cache line in the global memory
+ * @details The following lines are loaded as long as they are advised as
+ *          sequential too, up to a fixed depth. Runs on the asynchronous
+ *          worker, which the fault handler passes the missed line as a hint.
+ */
+static void prefetch_sequential(std::size_t line_offset){
+	const std::size_t block_size = pagesize*CACHELINE;
+	const std::size_t depth = std::min(sequential_prefetch_depth, cachesize/CACHELINE/2);
+	const std::size_t start = line_offset + block_size;
+	std::size_t end = start;
+	while(end < size_of_all && end < start + depth*block_size &&
+			has_advice(end, argo::advice::sequential)){
+		end += block_size;
+	}
+	if(end > start){
+		prefetch_range(static_cast<char*>(startAddr) + start, end - start);
+	}
+}
+
+void sync_write_backs(){
+	for(int i = 0; i < numtasks; i++){
+		if(barwindowsused[i] == 1){
+			MPI_Win_unlock(i, globalDataWindow[i]);
+			barwindowsused[i] = 0;
+		}
+	}
+}
+
+void argo_protect_memory(void* addr, std::size_t size, int prot){
+#ifdef ARGO_USERFAULTFD
+	argo_userfault->protect(addr, size, prot);
+#else
+	mprotect(addr, size, prot);
+#endif
+}
+
+void argo_map_memory(void* addr, std::size_t size, std::size_t offset, int prot){
+#ifdef ARGO_USERFAULTFD
+	argo_userfault->map(addr, size, offset, prot);
+#else
+	vm::map_memory(addr, size, offset, prot);
+#endif
+}
+
+/**
+ * @brief writes back and drops the cached copy of a cache line, if any
+ * @param line_offset offset of the cache line in the global memory
+ * @pre cachemutex and ibsem must be held
+ * @note the write back completes at the next sync_write_backs()
+ */
+static void drop_cached_line(std::size_t line_offset){
+	const std::size_t block_size = pagesize*CACHELINE;
+	unsigned long startIndex = getCacheIndex(line_offset);
+	if(cacheControl[startIndex].tag != line_offset || cacheControl[startIndex].state == INVALID){
+		return;
+	}
+	if(cacheControl[startIndex].dirty == DIRTY){
+		argo_protect_memory(static_cast<char*>(startAddr) + line_offset, block_size, PROT_READ);
+		for(int i = 0; i < CACHELINE; i++){
+			storepageDIFF(startIndex+i, line_offset+pagesize*i);
+		}
+		argo_write_buffer->erase(startIndex);
+	}
+	cacheControl[startIndex].dirty = CLEAN;
+	cacheControl[startIndex].state = INVALID;
+	touchedcache[startIndex] = 0;
+	argo_protect_memory(static_cast<char*>(startAddr) + line_offset, block_size, PROT_NONE);
+}
+
+/**
+ * @brief evicts the line held by a cache entry to make room for another line
+ * @param startidx index of the cache entry
+ * @param line_offset offset of the line to hold in the global memory
+ * @pre cachemutex and ibsem must be held
+ * @post the entry holds line_offset, mapped without access and INVALID,
+ *       unless it was unused or already held line_offset
+ */
+static void replace_cache_line(unsigned long startidx, unsigned long line_offset){
+	const std::size_t block_size = pagesize*CACHELINE;
+	const unsigned long tag = cacheControl[startidx].tag;
+	if(tag == GLOBAL_NULL || tag == line_offset){
+		return;
+	}
+	void* old_ptr = static_cast<char*>(startAddr) + tag;
+	if(cacheControl[startidx].dirty == DIRTY){
+		argo_protect_memory(old_ptr, block_size, PROT_READ);
+		for(int i = 0; i < CACHELINE; i++){
+			storepageDIFF(startidx+i, pagesize*i+tag);
+		}
+		argo_write_buffer->erase(startidx);
+	}
+	sync_write_backs();
+
+	cacheControl[startidx].state = INVALID;
+	cacheControl[startidx].tag = line_offset;
+	cacheControl[startidx].dirty = CLEAN;
+	argo_map_memory(static_cast<char*>(startAddr) + line_offset, block_size, pagesize*startidx, PROT_NONE);
+	argo_protect_memory(old_ptr, block_size, PROT_NONE);
+}
+
+/**
+ * @brief registers this node as a writer of a page, as on a write miss
+ * @param classidx classification index of the page
+ * @param homenode home node of the page
+ * @pre ibsem must be held
+ * @note nothing is done if this node is already a registered writer, or if
+ *       the page already has several writers and thus is invalidated anyway
+ */
+static void register_writer(unsigned long classidx, unsigned long homenode){
+	const unsigned long id = 1UL << getID();
+	const unsigned long invid = ~id;
+
+	MPI_Win_lock(MPI_LOCK_SHARED, workrank, 0, sharerWindow);
+	unsigned long writers = globalSharers[classidx+1];
+	unsigned long sharers = globalSharers[classidx];
+	MPI_Win_unlock(workrank, sharerWindow);
+	/* Either already registered write - or 1 or 0 other writers already cached */
+	if(writers == id || !isPowerOf2(writers)){
+		return;
+	}
+	MPI_Win_lock(MPI_LOCK_EXCLUSIVE, workrank, 0, sharerWindow);
+	globalSharers[classidx+1] |= id; //register locally
+	MPI_Win_unlock(workrank, sharerWindow);
+
+	if(homenode != getID()){
+		/* register and get latest sharers / writers */
+		MPI_Win_lock(MPI_LOCK_SHARED, homenode, 0, sharerWindow);
+		MPI_Get_accumulate(&id, 1,MPI_LONG,&writers,1,MPI_LONG,homenode,
+			classidx+1,1,MPI_LONG,MPI_BOR,sharerWindow);
+		MPI_Get(&sharers,1, MPI_LONG, homenode, classidx, 1,MPI_LONG,sharerWindow);
+		MPI_Win_unlock(homenode, sharerWindow);
+		/* Just add the (potentially) new sharers fetched to local copy */
+		MPI_Win_lock(MPI_LOCK_EXCLUSIVE, workrank, 0, sharerWindow);
+		globalSharers[classidx] |= sharers;
+		MPI_Win_unlock(workrank, sharerWindow);
+	}
+	/* We get result of accumulation before operation so we need to account for that */
+	writers |= id;
+
+	/* check if we need to update */
+	if(writers != id && isPowerOf2(writers&invid)){
+		for(int n = 0; n < numtasks; n++){
+			if((1UL<<n) == (writers&invid)){
+				MPI_Win_lock(MPI_LOCK_EXCLUSIVE, n, 0, sharerWindow);
+				MPI_Accumulate(&id, 1, MPI_LONG, n, classidx+1,1,MPI_LONG,MPI_BOR,sharerWindow);
+				MPI_Win_unlock(n, sharerWindow);
+				break;
+			}
+		}
+	}
+	else if(writers == id){
+		for(int n = 0; n < numtasks; n++){
+			if(n != workrank && ((1UL<<n)&sharers) != 0){
+				MPI_Win_lock(MPI_LOCK_EXCLUSIVE, n, 0, sharerWindow);
+				MPI_Accumulate(&id, 1, MPI_LONG, n, classidx+1,1,MPI_LONG,MPI_BOR,sharerWindow);
+				MPI_Win_unlock(n, sharerWindow);
+			}
+		}
+	}
+}
+
+/**
+ * @brief resolves an access to the global memory that is not permitted by its mapping
+ * @param fault_addr the address of the access
+ * @note a repeated fault on a readable line is taken as a write
+ */
+static void handle_fault(void* fault_addr){
 	double t1 = MPI_Wtime();
 
 	unsigned long tag;
 	argo_byte owner,state;
 	/* compute offset in distributed memory in bytes, always positive */
-	const std::size_t access_offset = static_cast<char*>(si->si_addr) - static_cast<char*>(startAddr);
+	const std::size_t access_offset = static_cast<char*>(fault_addr) - static_cast<char*>(startAddr);
 
 	/* align access offset to cacheline */
 	const std::size_t aligned_access_offset = align_backwards(access_offset, CACHELINE*pagesize);
@@ -267,13 +477,19 @@ void handler(int sig, siginfo_t *si, void *unused){
 	unsigned long startIndex = getCacheIndex(aligned_access_offset);
 	unsigned long homenode = getHomenode(aligned_access_offset, env::allocation_policy());
 	unsigned long offset = getOffset(aligned_access_offset, env::allocation_policy());
-	unsigned long id = 1 << getID();
+	unsigned long id = 1UL << getID();
 	unsigned long invid = ~id;
 
 	pthread_mutex_lock(&cachemutex);
 
 	/* page is local */
 	if(homenode == (getID())){
+		/* no other node accesses private pages, so no directory is kept */
+		if(has_advice(aligned_access_offset, argo::advice::node_private)){
+			argo_map_memory(aligned_access_ptr, pagesize*CACHELINE, cacheoffset+offset, PROT_READ|PROT_WRITE);
+			pthread_mutex_unlock(&cachemutex);
+			return;
+		}
 		int n;
 		sem_wait(&ibsem);
 		unsigned long sharers;
@@ -289,7 +505,7 @@ void handler(int sig, siginfo_t *si, void *unused){
 				unsigned long ownid = sharers&invid;
 				unsigned long owner = workrank;
 				for(n=0; n<numtasks; n++){
-					if((unsigned long)(1<<n)==ownid){
+					if((1UL<<n)==ownid){
 						owner = n; //just get rank...
 						break;
 					}
@@ -306,7 +522,7 @@ void handler(int sig, siginfo_t *si, void *unused){
 			}
 			/* set page to permit reads and map it to the page cache */
 			/** @todo Set cache offset to a variable instead of calculating it here */
-			vm::map_memory(aligned_access_ptr, pagesize*CACHELINE, cacheoffset+offset, PROT_READ);
+			argo_map_memory(aligned_access_ptr, pagesize*CACHELINE, cacheoffset+offset, PROT_READ);
 
 		}
 		else{
@@ -322,7 +538,7 @@ void handler(int sig, siginfo_t *si, void *unused){
 			if(writers != id && writers != 0 && isPowerOf2(writers&invid)){
 				int n;
 				for(n=0; n<numtasks; n++){
-					if(((unsigned long)(1<<n))==(writers&invid)){
+					if((1UL<<n)==(writers&invid)){
 						owner = n; //just get rank...
 						break;
 					}
@@ -334,7 +550,7 @@ void handler(int sig, siginfo_t *si, void *unused){
 			else if(writers == id || writers == 0){
 				int n;
 				for(n=0; n<numtasks; n++){
-					if(n != workrank && ((1<<n)&sharers) != 0){
+					if(n != workrank && ((1UL<<n)&sharers) != 0){
 						MPI_Win_lock(MPI_LOCK_EXCLUSIVE, n, 0, sharerWindow);
 						MPI_Accumulate(&id, 1, MPI_LONG, n, classidx+1,1,MPI_LONG,MPI_BOR,sharerWindow);
 						MPI_Win_unlock(n, sharerWindow);
@@ -342,7 +558,7 @@ void handler(int sig, siginfo_t *si, void *unused){
 				}
 			}
 			/* set page to permit read/write and map it to the page cache */
-			vm::map_memory(aligned_access_ptr, pagesize*CACHELINE, cacheoffset+offset, PROT_READ|PROT_WRITE);
+			argo_map_memory(aligned_access_ptr, pagesize*CACHELINE, cacheoffset+offset, PROT_READ|PROT_WRITE);
 
 		}
 		sem_post(&ibsem);
@@ -356,8 +572,14 @@ void handler(int sig, siginfo_t *si, void *unused){
 	if(state == INVALID || (tag != aligned_access_offset && tag != GLOBAL_NULL)) {
 		load_cache_entry(aligned_access_offset, (startIndex%cachesize));
 #if DUAL_LOAD == 1
-		prefetch_cache_entry((aligned_access_offset+CACHELINE*pagesize), ((startIndex+CACHELINE)%cachesize));
+		if(!has_advice(aligned_access_offset, argo::advice::random)){
+			prefetch_cache_entry((aligned_access_offset+CACHELINE*pagesize), ((startIndex+CACHELINE)%cachesize));
+		}
 #endif
+		/* a hint neither allocates nor blocks, as the fault handler must not */
+		if(has_advice(aligned_access_offset, argo::advice::sequential)){
+			argo_async_worker->hint(aligned_access_offset);
+		}
 		pthread_mutex_unlock(&cachemutex);
 		double t2 = MPI_Wtime();
 		stats.loadtime+=t2-t1;
@@ -376,65 +598,261 @@ void handler(int sig, siginfo_t *si, void *unused){
 	touchedcache[line] = 1;
 	cacheControl[line].dirty = DIRTY;
 
+	sem_wait(&ibsem);
+	if(!has_advice(aligned_access_offset, argo::advice::node_private)){
+		register_writer(classidx, homenode);
+	}
+	/* write-once lines are written back whole, so they need no twin */
+	if(!has_advice(aligned_access_offset, argo::advice::write_once)){
+		unsigned char * copy = (unsigned char *)(pagecopy + line*pagesize);
+		memcpy(copy,aligned_access_ptr,CACHELINE*pagesize);
+	}
+	argo_write_buffer->add(startIndex);
+	sem_post(&ibsem);
+	argo_protect_memory(aligned_access_ptr, pagesize*CACHELINE,PROT_WRITE|PROT_READ);
+	pthread_mutex_unlock(&cachemutex);
+	double t2 = MPI_Wtime();
+	stats.storetime += t2-t1;
+	return;
+}
+
+
+void handler(int sig, siginfo_t *si, void *unused){
+	UNUSED_PARAM(sig);
+	UNUSED_PARAM(unused);
+	handle_fault(si->si_addr);
+}
+
+void argo_prepare_remote_write(void* addr, std::size_t size){
+	if(size == 0){
+		return;
+	}
+	const std::size_t block_size = pagesize*CACHELINE;
+	const std::size_t access_offset = static_cast<char*>(addr) - static_cast<char*>(startAddr);
+	const std::size_t first = align_backwards(access_offset, block_size);
+
+	pthread_mutex_lock(&cachemutex);
+	sem_wait(&ibsem);
+	for(std::size_t line_offset = first; line_offset < access_offset + size; line_offset += block_size){
+		unsigned long classidx = get_classification_index(line_offset);
+		unsigned long homenode = getHomenode(line_offset);
+
+		/* write back and drop the cached copy, as it is updated behind its back */
+		if(homenode != getID()){
+			drop_cached_line(line_offset);
+		}
+
+		/* register as a writer, as on a write miss */
+		register_writer(classidx, homenode);
+	}
+	sync_write_backs();
+	sem_post(&ibsem);
+	pthread_mutex_unlock(&cachemutex);
+}
+
+void argo_set_advice(void* addr, std::size_t size, argo::advice hints){
+	const std::size_t block_size = pagesize*CACHELINE;
+	const std::size_t access_offset = static_cast<char*>(addr) - static_cast<char*>(startAddr);
+	if(size == 0 || access_offset >= size_of_all){
+		return;
+	}
+	const std::size_t end = std::min(access_offset + size, static_cast<std::size_t>(size_of_all));
+	const argo::advice coherence = argo::advice::read_only | argo::advice::node_private |
+		argo::advice::write_once;
+
+	/* make other nodes drop their copies once, instead of on every access */
+	if((hints & argo::advice::node_private) != argo::advice::normal){
+		argo_prepare_remote_write(addr, end - access_offset);
+	}
+
+	pthread_mutex_lock(&cachemutex);
+	sem_wait(&ibsem);
+	for(std::size_t line_offset = align_backwards(access_offset, block_size);
+			line_offset < end; line_offset += block_size){
+		argo_byte& line = line_advice[line_offset/block_size];
+		/* the cached state of the line may rely on the previous hints */
+		if((static_cast<argo::advice>(line) & coherence) != (hints & coherence)){
+			drop_cached_line(line_offset);
+			argo_protect_memory(static_cast<char*>(startAddr) + line_offset, block_size, PROT_NONE);
+		}
+		line = static_cast<argo_byte>(hints);
+	}
+	sync_write_backs();
+	sem_post(&ibsem);
+	pthread_mutex_unlock(&cachemutex);
+}
+
+bool argo_is_cached(const void* addr){
+	const std::size_t access_offset = static_cast<const char*>(addr) - static_cast<char*>(startAddr);
+	const std::size_t line_offset = align_backwards(access_offset, pagesize*CACHELINE);
+	if(getHomenode(line_offset, env::allocation_policy()) == getID()){
+		return true;
+	}
+	pthread_mutex_lock(&cachemutex);
+	const unsigned long startIndex = getCacheIndex(line_offset);
+	const bool cached = cacheControl[startIndex].tag == line_offset &&
+		cacheControl[startIndex].state != INVALID;
+	pthread_mutex_unlock(&cachemutex);
+	return cached;
+}
+
+bool argo_is_sharer(const void* addr, int node){
+	const std::size_t access_offset = static_cast<const char*>(addr) - static_cast<char*>(startAddr);
+	const unsigned long classidx = get_classification_index(align_backwards(access_offset, pagesize*CACHELINE));
 	sem_wait(&ibsem);
 	MPI_Win_lock(MPI_LOCK_SHARED, workrank, 0, sharerWindow);
-	unsigned long writers = globalSharers[classidx+1];
-	unsigned long sharers = globalSharers[classidx];
+	const unsigned long sharers = globalSharers[classidx];
 	MPI_Win_unlock(workrank, sharerWindow);
-	/* Either already registered write - or 1 or 0 other writers already cached */
-	if(writers != id && isPowerOf2(writers)){
-		MPI_Win_lock(MPI_LOCK_EXCLUSIVE, workrank, 0, sharerWindow);
-		globalSharers[classidx+1] |= id; //register locally
-		MPI_Win_unlock(workrank, sharerWindow);
+	sem_post(&ibsem);
+	return (sharers & (1UL << node)) != 0;
+}
 
-		/* register and get latest sharers / writers */
-		MPI_Win_lock(MPI_LOCK_SHARED, homenode, 0, sharerWindow);
-		MPI_Get_accumulate(&id, 1,MPI_LONG,&writers,1,MPI_LONG,homenode,
-			classidx+1,1,MPI_LONG,MPI_BOR,sharerWindow);
-		MPI_Get(&sharers,1, MPI_LONG, homenode, classidx, 1,MPI_LONG,sharerWindow);
-		MPI_Win_unlock(homenode, sharerWindow);
-		/* We get result of accumulation before operation so we need to account for that */
-		writers |= id;
-		/* Just add the (potentially) new sharers fetched to local copy */
+void argo_broadcast_range(void* addr, std::size_t size, int root){
+	const std::size_t block_size = pagesize*CACHELINE;
+	const std::size_t access_offset = static_cast<char*>(addr) - static_cast<char*>(startAddr);
+	if(size == 0 || access_offset >= size_of_all){
+		return;
+	}
+	const std::size_t end = std::min(access_offset + size, static_cast<std::size_t>(size_of_all));
+	const unsigned long id = 1ul << getID();
+	const unsigned long all = (numtasks >= 64) ? ~0ul : (1ul << numtasks) - 1;
+	std::vector<char> buffer;
+	std::vector<unsigned long> homes;
+	std::vector<unsigned long> directory;
+
+	for(std::size_t chunk = align_backwards(access_offset, block_size); chunk < end;
+			chunk += broadcast_chunk_lines*block_size){
+		const std::size_t lines = std::min(broadcast_chunk_lines, (end - chunk + block_size - 1)/block_size);
+		homes.resize(lines);
+		for(std::size_t i = 0; i < lines; i++){
+			homes[i] = getHomenode(chunk + i*block_size, env::allocation_policy());
+		}
+		buffer.resize(lines*block_size);
+		if(getID() == static_cast<unsigned int>(root)){
+			std::memcpy(buffer.data(), static_cast<char*>(startAddr) + chunk, lines*block_size);
+		}
+
+		/* the home nodes register all other nodes as sharers of their lines */
+		directory.assign(2*lines, 0);
+		pthread_mutex_lock(&cachemutex);
+		sem_wait(&ibsem);
 		MPI_Win_lock(MPI_LOCK_EXCLUSIVE, workrank, 0, sharerWindow);
-		globalSharers[classidx] |= sharers;
+		for(std::size_t i = 0; i < lines; i++){
+			if(homes[i] != getID() || has_advice(chunk + i*block_size, argo::advice::node_private)){
+				continue;
+			}
+			unsigned long classidx = get_classification_index(chunk + i*block_size);
+			globalSharers[classidx] |= all & ~id;
+			directory[2*i] = globalSharers[classidx];
+			directory[2*i+1] = globalSharers[classidx+1];
+		}
 		MPI_Win_unlock(workrank, sharerWindow);
+		sem_post(&ibsem);
+		pthread_mutex_unlock(&cachemutex);
 
-		/* check if we need to update */
-		if(writers != id && writers != 0 && isPowerOf2(writers&invid)){
-			int n;
-			for(n=0; n<numtasks; n++){
-				if(((unsigned long)(1<<n))==(writers&invid)){
-					owner = n; //just get rank...
-					break;
-				}
+		MPI_Request requests[2];
+		sem_wait(&ibsem);
+		MPI_Ibcast(buffer.data(), lines*block_size, MPI_BYTE, root, workcomm, &requests[0]);
+		MPI_Iallreduce(MPI_IN_PLACE, directory.data(), 2*lines, MPI_UNSIGNED_LONG, MPI_BOR,
+				workcomm, &requests[1]);
+		argo_complete_collective(&requests[0]);
+		argo_complete_collective(&requests[1]);
+		sem_post(&ibsem);
+
+		pthread_mutex_lock(&cachemutex);
+		sem_wait(&ibsem);
+		for(std::size_t i = 0; i < lines; i++){
+			const std::size_t line_offset = chunk + i*block_size;
+			if(homes[i] == getID() || has_advice(line_offset, argo::advice::node_private)){
+				continue;
 			}
-			MPI_Win_lock(MPI_LOCK_EXCLUSIVE, owner, 0, sharerWindow);
-			MPI_Accumulate(&id, 1, MPI_LONG, owner, classidx+1,1,MPI_LONG,MPI_BOR,sharerWindow);
-			MPI_Win_unlock(owner, sharerWindow);
-		}
-		else if(writers==id || writers==0){
-			int n;
-			for(n=0; n<numtasks; n++){
-				if(n != workrank && ((1<<n)&sharers) != 0){
-					MPI_Win_lock(MPI_LOCK_EXCLUSIVE, n, 0, sharerWindow);
-					MPI_Accumulate(&id, 1, MPI_LONG, n, classidx+1,1,MPI_LONG,MPI_BOR,sharerWindow);
-					MPI_Win_unlock(n, sharerWindow);
-				}
+			unsigned long classidx = get_classification_index(line_offset);
+			MPI_Win_lock(MPI_LOCK_EXCLUSIVE, workrank, 0, sharerWindow);
+			globalSharers[classidx] |= directory[2*i];
+			globalSharers[classidx+1] |= directory[2*i+1];
+			MPI_Win_unlock(workrank, sharerWindow);
+
+			/* a valid copy is the same data, or has writes of this node */
+			unsigned long startidx = getCacheIndex(line_offset);
+			if(cacheControl[startidx].tag == line_offset && cacheControl[startidx].state != INVALID){
+				continue;
+			}
+			void* lineptr = static_cast<char*>(startAddr) + line_offset;
+			const bool unused = cacheControl[startidx].tag == GLOBAL_NULL;
+			replace_cache_line(startidx, line_offset);
+			std::memcpy(&cacheData[startidx*pagesize], &buffer[i*block_size], block_size);
+			if(unused){
+				argo_map_memory(lineptr, block_size, pagesize*startidx, PROT_READ);
+				cacheControl[startidx].tag = line_offset;
+			}
+			else{
+				argo_protect_memory(lineptr, block_size, PROT_READ);
 			}
+			touchedcache[startidx] = 1;
+			cacheControl[startidx].state = VALID;
+			cacheControl[startidx].dirty = CLEAN;
 		}
+		sem_post(&ibsem);
+		pthread_mutex_unlock(&cachemutex);
 	}
-	unsigned char * copy = (unsigned char *)(pagecopy + line*pagesize);
-	memcpy(copy,aligned_access_ptr,CACHELINE*pagesize);
-	argo_write_buffer->add(startIndex);
-	sem_post(&ibsem);
-	mprotect(aligned_access_ptr, pagesize*CACHELINE,PROT_WRITE|PROT_READ);
-	pthread_mutex_unlock(&cachemutex);
-	double t2 = MPI_Wtime();
-	stats.storetime += t2-t1;
-	return;
 }
 
+/**
+ * @brief loads the remote pages of a range of the global memory into the cache
+ * @param addr start of the range
+ * @param size size of the range in bytes
+ */
+static void prefetch_range(void* addr, std::size_t size){
+	const std::size_t block_size = pagesize*CACHELINE;
+	const std::size_t access_offset = static_cast<char*>(addr) - static_cast<char*>(startAddr);
+	const std::size_t end = std::min(access_offset + size, static_cast<std::size_t>(size_of_all));
+	for(std::size_t line_offset = align_backwards(access_offset, block_size);
+			line_offset < end; line_offset += block_size){
+		/* pages of this node are not cached */
+		if(getHomenode(line_offset, env::allocation_policy()) == getID()){
+			continue;
+		}
+		pthread_mutex_lock(&cachemutex);
+		load_cache_entry(line_offset, getCacheIndex(line_offset) % cachesize);
+		pthread_mutex_unlock(&cachemutex);
+	}
+}
+
+std::uint64_t argo_async_submit(std::function<void()> op){
+	return argo_async_worker->submit(std::move(op));
+}
+
+std::uint64_t argo_prefetch_async(void* addr, std::size_t size){
+	return argo_async_submit([addr, size]{ prefetch_range(addr, size); });
+}
+
+void argo_async_wait(std::uint64_t t){
+	argo_async_worker->wait(t);
+}
+
+bool argo_async_test(std::uint64_t t){
+	return argo_async_worker->test(t);
+}
+
+void argo_register_home_function(void (*fn)(), argo::backend::home_function call){
+	argo_home_service->register_function(fn, call);
+}
+
+void argo_invoke_at_home(void* object, std::size_t object_size, void (*fn)(),
+		const void* arg, std::size_t arg_size, std::size_t result_size,
+		std::function<void(const void*)> done){
+	const std::size_t block_size = pagesize*CACHELINE;
+	const std::size_t offset = static_cast<char*>(object) - static_cast<char*>(startAddr);
+	if(object_size > 0 && align_backwards(offset, block_size) !=
+			align_backwards(offset + object_size - 1, block_size)){
+		throw std::invalid_argument("The object must not cross a page boundary");
+	}
+	const unsigned long homenode = getHomenode(offset, env::allocation_policy());
+	const unsigned long homeoffset = getOffset(offset, env::allocation_policy());
+	/* the update bypasses the caches, as a remote write of this node */
+	argo_prepare_remote_write(object, object_size);
+	argo_home_service->invoke(homenode, homeoffset, fn, arg, arg_size, result_size, std::move(done));
+}
 
 unsigned long getHomenode(unsigned long addr, char cloc){
 	std::size_t homenode;
@@ -471,9 +889,8 @@ unsigned long getOffset(unsigned long addr, char cloc){
 }
 
 void load_cache_entry(unsigned long loadtag, unsigned long loadline) {
-	int i;
 	unsigned long homenode;
-	unsigned long id = 1 << getID();
+	unsigned long id = 1UL << getID();
 	unsigned long invid = ~id;
 
 	if(loadtag>=size_of_all){//Trying to access/prefetch out of memory
@@ -512,37 +929,7 @@ void load_cache_entry(unsigned long loadtag, unsigned long loadline) {
 
 	void * lineptr = (char*)startAddr + lineAddr;
 
-	if(cacheControl[startidx].tag  != lineAddr){
-		if(cacheControl[startidx].tag  != lineAddr){
-
-			void * tmpptr2 = (char*)startAddr + cacheControl[startidx].tag;
-			if(cacheControl[startidx].tag != GLOBAL_NULL && cacheControl[startidx].tag  != lineAddr){
-				argo_byte dirty = cacheControl[startidx].dirty;
-				if(dirty == DIRTY){
-					mprotect(tmpptr2,blocksize,PROT_READ);
-					int j;
-					for(j=0; j < CACHELINE; j++){
-						storepageDIFF(startidx+j,pagesize*j+(cacheControl[startidx].tag));
-					}
-					argo_write_buffer->erase(startidx);
-				}
-
-				for(i = 0; i < numtasks; i++){
-					if(barwindowsused[i] == 1){
-						MPI_Win_unlock(i, globalDataWindow[i]);
-						barwindowsused[i] = 0;
-					}
-				}
-
-				cacheControl[startidx].state = INVALID;
-				cacheControl[startidx].tag = lineAddr;
-
-				cacheControl[startidx].dirty=CLEAN;
-				vm::map_memory(lineptr, blocksize, pagesize*startidx, PROT_NONE);
-				mprotect(tmpptr2,blocksize,PROT_NONE);
-			}
-		}
-	}
+	replace_cache_line(startidx, lineAddr);
 
 
 
@@ -557,7 +944,8 @@ void load_cache_entry(unsigned long loadtag, unsigned long loadline) {
 	int n;
 	homenode = getHomenode(lineAddr);
 
-	if(prevsharer==0 ){ //if there is strictly less than two 'stable' sharers
+	/* private lines are not registered, as no other node accesses them */
+	if(prevsharer==0 && !has_advice(lineAddr, argo::advice::node_private)){ //if there is strictly less than two 'stable' sharers
 		MPI_Win_lock(MPI_LOCK_SHARED, homenode, 0, sharerWindow);
 		MPI_Get_accumulate(&id, 1, MPI_LONG, &tempsharer, 1, MPI_LONG,
 			homenode, classidx, 1, MPI_LONG, MPI_BOR, sharerWindow);
@@ -597,11 +985,11 @@ void load_cache_entry(unsigned long loadtag, unsigned long loadline) {
 	MPI_Win_unlock(homenode, globalDataWindow[homenode]);
 
 	if(cacheControl[startidx].tag == GLOBAL_NULL){
-		vm::map_memory(lineptr, blocksize, pagesize*startidx, PROT_READ);
+		argo_map_memory(lineptr, blocksize, pagesize*startidx, PROT_READ);
 		cacheControl[startidx].tag = lineAddr;
 	}
 	else{
-		mprotect(lineptr,pagesize*CACHELINE,PROT_READ);
+		argo_protect_memory(lineptr,pagesize*CACHELINE,PROT_READ);
 	}
 	touchedcache[startidx] = 1;
 	cacheControl[startidx].state = VALID;
@@ -613,7 +1001,7 @@ void load_cache_entry(unsigned long loadtag, unsigned long loadline) {
 void prefetch_cache_entry(unsigned long prefetchtag, unsigned long prefetchline) {
 	int i;
 	unsigned long homenode;
-	unsigned long id = 1 << getID();
+	unsigned long id = 1UL << getID();
 	unsigned long invid = ~id;
 	if(prefetchtag>=size_of_all){//Trying to access/prefetch out of memory
 		return;
@@ -657,7 +1045,7 @@ void prefetch_cache_entry(unsigned long prefetchtag, unsigned long prefetchline)
 			if(cacheControl[startidx].tag != GLOBAL_NULL && cacheControl[startidx].tag  != lineAddr){
 				argo_byte dirty = cacheControl[startidx].dirty;
 				if(dirty == DIRTY){
-					mprotect(tmpptr2,blocksize,PROT_READ);
+					argo_protect_memory(tmpptr2,blocksize,PROT_READ);
 					int j;
 					for(j=0; j < CACHELINE; j++){
 						storepageDIFF(startidx+j,pagesize*j+(cacheControl[startidx].tag));
@@ -677,8 +1065,8 @@ void prefetch_cache_entry(unsigned long prefetchtag, unsigned long prefetchline)
 				cacheControl[startidx].tag = lineAddr;
 				cacheControl[startidx].dirty=CLEAN;
 
-				vm::map_memory(lineptr, blocksize, pagesize*startidx, PROT_NONE);
-				mprotect(tmpptr2,blocksize,PROT_NONE);
+				argo_map_memory(lineptr, blocksize, pagesize*startidx, PROT_NONE);
+				argo_protect_memory(tmpptr2,blocksize,PROT_NONE);
 
 			}
 		}
@@ -694,7 +1082,8 @@ void prefetch_cache_entry(unsigned long prefetchtag, unsigned long prefetchline)
 	int n;
 	homenode = getHomenode(lineAddr);
 
-	if(prevsharer==0 ){ //if there is strictly less than two 'stable' sharers
+	/* private lines are not registered, as no other node accesses them */
+	if(prevsharer==0 && !has_advice(lineAddr, argo::advice::node_private)){ //if there is strictly less than two 'stable' sharers
 		MPI_Win_lock(MPI_LOCK_SHARED, homenode, 0, sharerWindow);
 		MPI_Get_accumulate(&id, 1, MPI_LONG, &tempsharer, 1, MPI_LONG,
 			homenode, classidx, 1, MPI_LONG, MPI_BOR, sharerWindow);
@@ -732,11 +1121,11 @@ void prefetch_cache_entry(unsigned long prefetchtag, unsigned long prefetchline)
 
 
 	if(cacheControl[startidx].tag == GLOBAL_NULL){
-		vm::map_memory(lineptr, blocksize, pagesize*startidx, PROT_READ);
+		argo_map_memory(lineptr, blocksize, pagesize*startidx, PROT_READ);
 		cacheControl[startidx].tag = lineAddr;
 	}
 	else{
-		mprotect(lineptr,pagesize*CACHELINE,PROT_READ);
+		argo_protect_memory(lineptr,pagesize*CACHELINE,PROT_READ);
 	}
 
 	touchedcache[startidx] = 1;
@@ -860,6 +1249,7 @@ void argo_initialize(std::size_t argo_size, std::size_t cache_size){
 
 	classificationSize = 2*cachesize; // Could be smaller ?
 	argo_write_buffer = new write_buffer<std::size_t>();
+	argo_async_worker = new async_worker(prefetch_sequential);
 
 	barwindowsused = (char *)malloc(numtasks*sizeof(char));
 	for(i = 0; i < numtasks; i++){
@@ -912,6 +1302,11 @@ void argo_initialize(std::size_t argo_size, std::size_t cache_size){
 		printf("malloc error out of memory\n");
 		exit(EXIT_FAILURE);
 	}
+	line_advice = (argo_byte *)calloc(size_of_all/(pagesize*CACHELINE), sizeof(argo_byte));
+	if(line_advice == NULL){
+		printf("malloc error out of memory\n");
+		exit(EXIT_FAILURE);
+	}
 
 	lockbuffer = static_cast<unsigned long*>(vm::allocate_mappable(pagesize, pagesize));
 	pagecopy = static_cast<char*>(vm::allocate_mappable(pagesize, cachesize*pagesize));
@@ -968,6 +1363,10 @@ void argo_initialize(std::size_t argo_size, std::size_t cache_size){
 									 MPI_INFO_NULL, MPI_COMM_WORLD, &globalDataWindow[i]);
 	}
 
+	MPI_Win_create(globalData, size_of_chunk*sizeof(argo_byte), 1,
+								 MPI_INFO_NULL, MPI_COMM_WORLD, &atomicWindow);
+	MPI_Win_lock_all(0, atomicWindow);
+
 	MPI_Win_create(globalSharers, gwritersize, sizeof(unsigned long),
 								 MPI_INFO_NULL, MPI_COMM_WORLD, &sharerWindow);
 	MPI_Win_create(lockbuffer, pagesize, 1, MPI_INFO_NULL, MPI_COMM_WORLD, &lockWindow);
@@ -998,6 +1397,10 @@ void argo_initialize(std::size_t argo_size, std::size_t cache_size){
 		cacheControl[j].dirty = CLEAN;
 	}
 
+	argo_home_service = new home_service(workcomm, &ibsem, globalData);
+#ifdef ARGO_USERFAULTFD
+	argo_userfault = new userfault_service(startAddr, size_of_all, &handle_fault);
+#endif
 	argo_reset_coherence(1);
 }
 
@@ -1008,6 +1411,11 @@ void argo_finalize(){
 		printf("ArgoDSM shutting down\n");
 	}
 	swdsm_argo_barrier(1);
+	/* the service thread must stop before MPI is used without ibsem */
+	delete argo_home_service;
+#ifdef ARGO_USERFAULTFD
+	delete argo_userfault;
+#endif
 	mprotect(startAddr,size_of_all,PROT_WRITE|PROT_READ);
 	MPI_Barrier(MPI_COMM_WORLD);
 	if (env::print_statistics()==1) {
@@ -1017,10 +1425,14 @@ void argo_finalize(){
 		}
 	}
 	}
+	/* complete the asynchronous operations while the windows exist */
+	delete argo_async_worker;
 	MPI_Barrier(MPI_COMM_WORLD);
 	for(i=0; i<numtasks; i++){
 		MPI_Win_free(&globalDataWindow[i]);
 	}
+	MPI_Win_unlock_all(atomicWindow);
+	MPI_Win_free(&atomicWindow);
 	MPI_Win_free(&sharerWindow);
 	MPI_Win_free(&lockWindow);
 	if (dd::is_first_touch_policy()) {
@@ -1033,10 +1445,14 @@ void argo_finalize(){
 }
 
 void self_invalidation(){
+	self_invalidation(~0ul);
+}
+
+void self_invalidation(unsigned long nodes){
 	unsigned long i;
 	double t1,t2;
 	int flushed = 0;
-	unsigned long id = 1 << getID();
+	unsigned long id = 1UL << getID();
 
 	t1 = MPI_Wtime();
 	for(i = 0; i < cachesize; i+=CACHELINE){
@@ -1047,17 +1463,26 @@ void self_invalidation(){
 			unsigned long classidx = get_classification_index(lineAddr);
 			argo_byte dirty = cacheControl[i].dirty;
 
+			/* read-only and private lines are not changed by other nodes */
+			if(has_advice(lineAddr, argo::advice::read_only | argo::advice::node_private)){
+				continue;
+			}
+
 			if(flushed == 0 && dirty == DIRTY){
 				argo_write_buffer->flush();
 				flushed = 1;
 			}
 			MPI_Win_lock(MPI_LOCK_SHARED, workrank, 0, sharerWindow);
+			unsigned long writers = globalSharers[classidx+1];
 			if(
 				 // node is single writer
-				 (globalSharers[classidx+1]==id)
+				 (writers==id)
 				 ||
 				 // No writer and assert that the node is a sharer
-				 ((globalSharers[classidx+1]==0) && ((globalSharers[classidx]&id)==id))
+				 ((writers==0) && ((globalSharers[classidx]&id)==id))
+				 ||
+				 // the other writers do not synchronize with this node
+				 (writers!=0 && (writers&~id&nodes)==0)
 				 ){
 				MPI_Win_unlock(workrank, sharerWindow);
 				touchedcache[i] =1;
@@ -1068,7 +1493,7 @@ void self_invalidation(){
 				cacheControl[i].dirty=CLEAN;
 				cacheControl[i].state = INVALID;
 				touchedcache[i] =0;
-				mprotect((char*)startAddr + lineAddr, pagesize*CACHELINE, PROT_NONE);
+				argo_protect_memory((char*)startAddr + lineAddr, pagesize*CACHELINE, PROT_NONE);
 			}
 		}
 	}
@@ -1076,15 +1501,45 @@ void self_invalidation(){
 	stats.selfinvtime += (t2-t1);
 }
 
+void argo_complete_collective(MPI_Request* request){
+	int done;
+	if(!argo_home_service->running()){
+		/* no requests to serve, so keep ibsem as a blocking collective does */
+		MPI_Wait(request, MPI_STATUS_IGNORE);
+		return;
+	}
+	MPI_Test(request, &done, MPI_STATUS_IGNORE);
+	while(!done){
+		/* let the other threads of the node communicate meanwhile */
+		sem_post(&ibsem);
+		sched_yield();
+		sem_wait(&ibsem);
+		MPI_Test(request, &done, MPI_STATUS_IGNORE);
+	}
+}
+
+void argo_wait_for_releases(){
+	argo_async_wait(release_ticket.load());
+}
+
 void swdsm_argo_barrier(int n){ //BARRIER
+	swdsm_group_barrier(workcomm, ~0ul, n);
+}
+
+void swdsm_group_barrier(MPI_Comm comm, unsigned long nodes, int n){
 	double time1,time2;
 	pthread_t barrierlockholder;
+	const unsigned long all = (numtasks >= 64) ? ~0ul : (1ul << numtasks) - 1;
+	/* a team of this node alone has no other node to synchronize with */
+	const bool alone = comm != workcomm && (nodes & all & ~(1ul << getID())) == 0;
 	time1 = MPI_Wtime();
-	pthread_barrier_wait(&threadbarrier[n]);
-	if(argo_get_nodes()==1){
+	argo_wait_for_releases();
+	if(pthread_barrier_wait(&threadbarrier[n]) == PTHREAD_BARRIER_SERIAL_THREAD && alone){
 		time2 = MPI_Wtime();
 		stats.barriers++;
 		stats.barriertime += (time2-time1);
+	}
+	if(alone){
 		return;
 	}
 
@@ -1093,8 +1548,10 @@ void swdsm_argo_barrier(int n){ //BARRIER
 		pthread_mutex_lock(&cachemutex);
 		sem_wait(&ibsem);
 		argo_write_buffer->flush();
-		MPI_Barrier(workcomm);
-		self_invalidation();
+		MPI_Request request;
+		MPI_Ibarrier(comm, &request);
+		argo_complete_collective(&request);
+		self_invalidation(nodes);
 		sem_post(&ibsem);
 		pthread_mutex_unlock(&cachemutex);
 	}
@@ -1108,11 +1565,83 @@ void swdsm_argo_barrier(int n){ //BARRIER
 	}
 }
 
+/**
+ * @brief Combines the values of the local threads, then reduces them across the nodes
+ * @param value the value of the calling thread, replaced by the result
+ * @param type MPI type of the value
+ * @param op MPI operation combining the values
+ * @param n number of local threads participating
+ * @param collective reduces reductionvalue across the nodes, called by one thread
+ */
+template<typename F>
+static void node_reduction(void* value, MPI_Datatype type, MPI_Op op, int n, F collective){
+	int size;
+	pthread_mutex_lock(&reductionmutex);
+	sem_wait(&ibsem);
+	MPI_Type_size(type, &size);
+	if(reductioncontributors == 0){
+		memcpy(reductionvalue, value, size);
+	}
+	else{
+		MPI_Reduce_local(value, reductionvalue, 1, type, op);
+	}
+	sem_post(&ibsem);
+	reductioncontributors++;
+	pthread_mutex_unlock(&reductionmutex);
+
+	if(pthread_barrier_wait(&threadbarrier[n]) == PTHREAD_BARRIER_SERIAL_THREAD){
+		reductioncontributors = 0;
+		if(argo_get_nodes() > 1){
+			collective();
+		}
+	}
+	pthread_barrier_wait(&threadbarrier[n]);
+	memcpy(value, reductionvalue, size);
+	/* no thread may start the next reduction before all have the result */
+	pthread_barrier_wait(&threadbarrier[n]);
+}
+
+void swdsm_argo_allreduce(void* value, MPI_Datatype type, MPI_Op op, int n){
+	double time1 = MPI_Wtime();
+	argo_wait_for_releases();
+	node_reduction(value, type, op, n, [&]{
+		pthread_mutex_lock(&cachemutex);
+		sem_wait(&ibsem);
+		argo_write_buffer->flush();
+		/* the reduction synchronizes the nodes as MPI_Barrier would */
+		MPI_Request request;
+		MPI_Iallreduce(MPI_IN_PLACE, reductionvalue, 1, type, op, workcomm, &request);
+		argo_complete_collective(&request);
+		self_invalidation();
+		sem_post(&ibsem);
+		pthread_mutex_unlock(&cachemutex);
+		stats.barriers++;
+		stats.barriertime += MPI_Wtime()-time1;
+	});
+}
+
+void swdsm_argo_reduce(void* value, MPI_Datatype type, MPI_Op op, int root, int n){
+	node_reduction(value, type, op, n, [&]{
+		MPI_Request request;
+		sem_wait(&ibsem);
+		if(root == workrank){
+			MPI_Ireduce(MPI_IN_PLACE, reductionvalue, 1, type, op, root, workcomm, &request);
+		}
+		else{
+			MPI_Ireduce(reductionvalue, nullptr, 1, type, op, root, workcomm, &request);
+		}
+		argo_complete_collective(&request);
+		sem_post(&ibsem);
+	});
+}
+
 void argo_reset_coherence(int n){
 	unsigned long j;
+	argo_async_worker->drain();
 	stats.writebacks = 0;
 	stats.stores = 0;
 	memset(touchedcache, 0, cachesize);
+	memset(line_advice, 0, size_of_all/(pagesize*CACHELINE));
 
 	sem_wait(&ibsem);
 	MPI_Win_lock(MPI_LOCK_EXCLUSIVE, workrank, 0, sharerWindow);
@@ -1140,13 +1669,14 @@ void argo_reset_coherence(int n){
 	}
 	sem_post(&ibsem);
 	swdsm_argo_barrier(n);
-	mprotect(startAddr,size_of_all,PROT_NONE);
+	argo_protect_memory(startAddr,size_of_all,PROT_NONE);
 	swdsm_argo_barrier(n);
 	clearStatistics();
 }
 
 void argo_acquire(){
 	int flag;
+	argo_wait_for_releases();
 	pthread_mutex_lock(&cachemutex);
 	sem_wait(&ibsem);
 	self_invalidation();
@@ -1156,6 +1686,17 @@ void argo_acquire(){
 }
 
 
+void argo_group_acquire(unsigned long nodes){
+	int flag;
+	argo_wait_for_releases();
+	pthread_mutex_lock(&cachemutex);
+	sem_wait(&ibsem);
+	self_invalidation(nodes);
+	MPI_Iprobe(MPI_ANY_SOURCE,MPI_ANY_TAG,workcomm,&flag,MPI_STATUS_IGNORE);
+	sem_post(&ibsem);
+	pthread_mutex_unlock(&cachemutex);
+}
+
 void argo_release(){
 	int flag;
 	pthread_mutex_lock(&cachemutex);
@@ -1166,6 +1707,14 @@ void argo_release(){
 	pthread_mutex_unlock(&cachemutex);
 }
 
+std::uint64_t argo_submit_release(){
+	const std::uint64_t ticket = argo_async_submit([]{ argo_release(); });
+	/* releases may be submitted by several threads at once */
+	std::uint64_t last = release_ticket.load();
+	while(last < ticket && !release_ticket.compare_exchange_weak(last, ticket)){}
+	return ticket;
+}
+
 void argo_acq_rel(){
 	argo_acquire();
 	argo_release();
@@ -1207,6 +1756,13 @@ void storepageDIFF(unsigned long index, unsigned long addr){
 		barwindowsused[homenode] = 1;
 	}
 
+	/* write-once pages have no twin, and are written back whole */
+	if(has_advice(addr, argo::advice::write_once)){
+		MPI_Put(real, pagesize, MPI_BYTE, homenode, offset, pagesize, MPI_BYTE, globalDataWindow[homenode]);
+		stats.stores++;
+		return;
+	}
+
 	for(i = 0; i < pagesize; i+=drf_unit){
 		int branchval;
 		for(j=i; j < i+drf_unit; j++){
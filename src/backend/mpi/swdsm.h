@@ -11,6 +11,7 @@
 
 /* Includes */
 #include <cstdint>
+#include <functional>
 #include <type_traits>
 
 #include <assert.h>
@@ -33,6 +34,7 @@
 #include <unistd.h>
 
 #include "argo.h"
+#include "backend/backend.hpp"
 /** @brief Granularity of coherence unit / pagesize  */
 #define GRAN 4096L //page size.
 
@@ -137,6 +139,24 @@ constexpr std::size_t page_size = 4096;
  * @see signal.h
  */
 void handler(int sig, siginfo_t *si, void *unused);
+/**
+ * @brief Changes the access to a range of the global memory
+ * @param addr start of the range
+ * @param size size of the range in bytes
+ * @param prot the access as for mprotect
+ * @note Use this instead of mprotect on the global memory, as the page
+ *       faults may not be served through a signal handler
+ */
+void argo_protect_memory(void* addr, std::size_t size, int prot);
+/**
+ * @brief Maps backing memory into the global memory
+ * @param addr the address to map to
+ * @param size size of the mapping in bytes
+ * @param offset offset into the backing memory
+ * @param prot the access as for mprotect
+ * @see argo::virtual_memory::map_memory
+ */
+void argo_map_memory(void* addr, std::size_t size, std::size_t offset, int prot);
 /**
  * @brief Sets up ArgoDSM's signal handler
  */
@@ -170,6 +190,14 @@ void * argo_gmalloc(unsigned long size);
  */
 void self_invalidation();
 
+/**
+ * @brief Self-Invalidates the memory that has potential writers among a set of nodes
+ * @param nodes bitmask of the nodes the calling node synchronizes with
+ * @details Pages written only by nodes outside of the set are kept, as
+ *          the synchronization does not order their writes anyway.
+ */
+void self_invalidation(unsigned long nodes);
+
 /**
  * @brief Global barrier for ArgoDSM - needs to be called by every thread in the
  *        system that need coherent view of the memory
@@ -177,6 +205,42 @@ void self_invalidation();
  */
 void swdsm_argo_barrier(int n);
 
+/**
+ * @brief Barrier over a subset of the ArgoDSM nodes
+ * @param comm communicator of the nodes in the subset
+ * @param nodes bitmask of the nodes in the subset
+ * @param n number of local thread participating
+ * @details Writes back the cache as swdsm_argo_barrier does, but only
+ *          invalidates the pages with writers in the subset. A team of
+ *          the calling node alone only synchronizes the local threads.
+ * @see self_invalidation(unsigned long)
+ */
+void swdsm_group_barrier(MPI_Comm comm, unsigned long nodes, int n);
+
+/**
+ * @brief Global reduction for ArgoDSM that also acts as swdsm_argo_barrier
+ * @param value the value of the calling thread, replaced by the reduced value
+ * @param type MPI type of the value
+ * @param op MPI operation combining the values
+ * @param n number of local threads participating
+ * @details The values of the local threads are combined first, so only a
+ *          single value per node takes part in the reduction across the
+ *          nodes, which replaces the MPI_Barrier of swdsm_argo_barrier.
+ */
+void swdsm_argo_allreduce(void* value, MPI_Datatype type, MPI_Op op, int n);
+
+/**
+ * @brief Global reduction for ArgoDSM to a single node
+ * @param value the value of the calling thread, replaced by the reduced value
+ *              on the root node, unspecified on the other nodes
+ * @param type MPI type of the value
+ * @param op MPI operation combining the values
+ * @param root the node receiving the reduced value
+ * @param n number of local threads participating
+ * @note unlike swdsm_argo_allreduce, this does not synchronize the memory
+ */
+void swdsm_argo_reduce(void* value, MPI_Datatype type, MPI_Op op, int root, int n);
+
 /**
  * @brief acquire function for ArgoDSM (Acquire according to Release Consistency)
  */
@@ -186,6 +250,28 @@ void argo_acquire();
  */
 void argo_release();
 
+/**
+ * @brief Acquire with respect to a subset of the ArgoDSM nodes
+ * @param nodes bitmask of the nodes the calling node synchronizes with
+ * @see self_invalidation(unsigned long)
+ */
+void argo_group_acquire(unsigned long nodes);
+
+/**
+ * @brief starts a release in the background
+ * @return ticket to wait for the release with
+ * @details The release is executed by the asynchronous worker, and covers
+ *          at least the writes before the call. The next acquire or barrier
+ *          of the node waits for it.
+ */
+std::uint64_t argo_submit_release();
+
+/**
+ * @brief waits for the asynchronous releases of this node
+ * @note must not be called with cachemutex or ibsem held
+ */
+void argo_wait_for_releases();
+
 /**
  * @brief acquire-release function for ArgoDSM (Both acquire and release
  *        according to Release Consistency)
@@ -199,6 +285,132 @@ void argo_acq_rel();
  */
 void storepageDIFF(unsigned long index, unsigned long addr);
 
+/**
+ * @brief completes the write backs stored by storepageDIFF since the last sync
+ * @pre ibsem must be held
+ */
+void sync_write_backs();
+
+/**
+ * @brief checks whether a cache line has any of a set of access hints
+ * @param line_offset offset of the cache line in the global memory
+ * @param hints the hints to check for
+ * @return true if any of the hints is set for the line
+ * @see argo_set_advice
+ */
+bool has_advice(std::size_t line_offset, argo::advice hints);
+
+/**
+ * @brief prepares a range of the global memory to be written without the page cache
+ * @param addr start of the range
+ * @param size size of the range in bytes
+ * @details Registers the node as a writer of the pages in the range, as
+ *          a write miss does, so that nodes caching them self-invalidate
+ *          them on their next acquire. Cached copies of the pages on the
+ *          local node are written back and dropped.
+ * @note needed before updating global memory directly, e.g. through
+ *       remote atomic operations, if plain accesses are to see the update
+ */
+void argo_prepare_remote_write(void* addr, std::size_t size);
+
+/**
+ * @brief completes a nonblocking collective operation
+ * @param request the request of the operation
+ * @pre ibsem must be held, and is held again on return
+ * @details Once the home service is running, ibsem is released while
+ *          waiting for the other nodes, so that it can serve the requests
+ *          of nodes not yet in the collective. Otherwise the operation
+ *          blocks with ibsem held.
+ */
+void argo_complete_collective(MPI_Request* request);
+
+/**
+ * @brief queues an operation for the asynchronous worker of this node
+ * @param op the operation to execute
+ * @return ticket to wait for the operation with
+ * @details The operations are executed in order by a single worker thread.
+ */
+std::uint64_t argo_async_submit(std::function<void()> op);
+
+/**
+ * @brief starts loading a range of the global memory into the cache in the background
+ * @param addr start of the range
+ * @param size size of the range in bytes
+ * @return ticket to wait for the prefetch with
+ * @details The prefetches are executed in order by a worker thread, which
+ *          loads the remote pages of the range as read misses would.
+ */
+std::uint64_t argo_prefetch_async(void* addr, std::size_t size);
+
+/**
+ * @brief sets the access hints of a range of the global memory on this node
+ * @param addr start of the range
+ * @param size size of the range in bytes
+ * @param hints the hints of the pages overlapping the range
+ * @see argo::backend::advise
+ */
+void argo_set_advice(void* addr, std::size_t size, argo::advice hints);
+
+/**
+ * @brief checks whether a page of the global memory is valid on this node
+ * @param addr an address in the page
+ * @return true if the page is homed on this node or validly cached
+ * @see argo::backend::_is_cached
+ */
+bool argo_is_cached(const void* addr);
+
+/**
+ * @brief checks whether the directory of this node lists a node as a sharer of a page
+ * @param addr an address in the page
+ * @param node the node to check for
+ * @return true if node is registered as a sharer
+ * @see argo::backend::_is_sharer
+ */
+bool argo_is_sharer(const void* addr, int node);
+
+/**
+ * @brief loads a range of the global memory into the caches of all nodes
+ * @param addr start of the range
+ * @param size size of the range in bytes
+ * @param root the node whose view of the range is sent
+ * @details The pages are sent with collective broadcasts instead of being
+ *          loaded from their home nodes by every node, and all nodes are
+ *          registered as sharers with one collective operation.
+ * @note Collective over all nodes. The range must not be written until
+ *       all nodes have returned.
+ * @see argo::backend::broadcast_range
+ */
+void argo_broadcast_range(void* addr, std::size_t size, int root);
+
+/**
+ * @brief waits for an asynchronous operation
+ * @param t the ticket of the operation
+ */
+void argo_async_wait(std::uint64_t t);
+
+/**
+ * @brief checks whether an asynchronous operation has completed
+ * @param t the ticket of the operation
+ * @return true if the operation has completed
+ */
+bool argo_async_test(std::uint64_t t);
+
+/**
+ * @brief registers a function to run at the home node of its object
+ * @param fn the function
+ * @param call calls fn on the backing memory of the object
+ * @see argo::backend::register_function
+ */
+void argo_register_home_function(void (*fn)(), argo::backend::home_function call);
+
+/**
+ * @brief runs a registered function at the home node of an object
+ * @see argo::backend::invoke_at_home
+ */
+void argo_invoke_at_home(void* object, std::size_t object_size, void (*fn)(),
+		const void* arg, std::size_t arg_size, std::size_t result_size,
+		std::function<void(const void*)> done);
+
 /*Statistics*/
 /**
  * @brief Clears out all statistics
@@ -280,7 +492,10 @@ int argo_get_global_tid();
 void argo_register_thread();
 /**
  * @brief Pins and registers the local thread
+ * @details The CPU is chosen from the local thread ID according to the NUMA
+ *          topology and the pinning policy.
  * @see argo_register_thread()
+ * @see @ref ARGO_PIN_POLICY
  */
 void argo_pin_threads();
 
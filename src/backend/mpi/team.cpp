@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief This file implements teams of nodes synchronizing without the other nodes
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "../backend.hpp"
+#include "swdsm.h"
+
+// EXTERNAL VARIABLES FROM BACKEND
+/**
+ * @brief ibsem is used to serialize all Infiniband (MPI) operations
+ * @deprecated Should not be needed once the cache module is implemented
+ */
+extern sem_t ibsem;
+/**
+ * @brief The teams are created from the communicator of all nodes
+ */
+extern MPI_Comm workcomm;
+
+namespace {
+	/** @brief A team of nodes */
+	struct team_data {
+		/** @brief the communicator of the members, MPI_COMM_NULL once freed */
+		MPI_Comm comm;
+		/** @brief the members in increasing order, their ranks in comm */
+		std::vector<argo::node_id_t> members;
+		/** @brief bitmask of the members */
+		unsigned long nodes;
+	};
+
+	/** @brief Protects the teams */
+	std::mutex team_mutex;
+
+	/**
+	 * @brief The teams of this node, indexed by their handles
+	 * @note A deque, so that creating a team leaves the references
+	 *       returned by find_team valid
+	 */
+	std::deque<team_data> teams;
+
+	/**
+	 * @brief look up a team
+	 * @param team the handle of the team
+	 * @return the team
+	 * @throws std::invalid_argument if the team does not exist
+	 */
+	team_data& find_team(argo::backend::team_handle team) {
+		std::lock_guard<std::mutex> lock(team_mutex);
+		if(team >= teams.size() || teams[team].comm == MPI_COMM_NULL) {
+			throw std::invalid_argument("The team does not exist");
+		}
+		return teams[team];
+	}
+} // namespace
+
+namespace argo {
+	namespace backend {
+		team_handle team_create(const node_id_t* members, std::size_t count) {
+			team_data team{MPI_COMM_NULL, std::vector<node_id_t>(members, members + count), 0};
+			for(auto member : team.members) {
+				team.nodes |= 1ul << member;
+			}
+			MPI_Group all, group;
+			sem_wait(&ibsem);
+			MPI_Comm_group(workcomm, &all);
+			MPI_Group_incl(all, count, team.members.data(), &group);
+			/* only the members take part */
+			MPI_Comm_create_group(workcomm, group, 0, &team.comm);
+			MPI_Group_free(&group);
+			MPI_Group_free(&all);
+			sem_post(&ibsem);
+
+			std::lock_guard<std::mutex> lock(team_mutex);
+			teams.push_back(std::move(team));
+			return teams.size() - 1;
+		}
+
+		void team_free(team_handle team) {
+			MPI_Comm comm = find_team(team).comm;
+			sem_wait(&ibsem);
+			MPI_Comm_free(&comm);
+			sem_post(&ibsem);
+			std::lock_guard<std::mutex> lock(team_mutex);
+			teams[team].comm = MPI_COMM_NULL;
+		}
+
+		void team_barrier(team_handle team, std::size_t threadcount) {
+			team_data& t = find_team(team);
+			atomic::_flush_ops();
+			swdsm_group_barrier(t.comm, t.nodes, threadcount);
+		}
+
+		void _team_broadcast(team_handle team, node_id_t source, void* ptr, std::size_t size) {
+			team_data& t = find_team(team);
+			auto it = std::lower_bound(t.members.begin(), t.members.end(), source);
+			if(it == t.members.end() || *it != source) {
+				throw std::invalid_argument("The source of a team broadcast must be a member");
+			}
+			MPI_Request request;
+			sem_wait(&ibsem);
+			MPI_Ibcast(ptr, size, MPI_BYTE, it - t.members.begin(), t.comm, &request);
+			argo_complete_collective(&request);
+			sem_post(&ibsem);
+		}
+
+		void team_acquire(team_handle team) {
+			argo_group_acquire(find_team(team).nodes);
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+
+		void team_release(team_handle team) {
+			find_team(team);
+			release();
+		}
+	} // namespace backend
+} // namespace argo
@@ -0,0 +1,265 @@
+/**
+ * @file
+ * @brief This file provides a service thread resolving page faults delivered through userfaultfd
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_userfault_hpp
+#define argo_userfault_hpp argo_userfault_hpp
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "virtual_memory/virtual_memory.hpp"
+
+/**
+ * @brief	A service thread resolving the page faults of the global memory
+ * @details	Instead of protecting pages with mprotect and serving the
+ *		resulting SIGSEGV on the faulting thread, the global memory is
+ *		registered with userfaultfd for missing, minor and write-protect
+ *		faults. A page without access has no page table entry, so
+ *		accessing it raises a minor fault. A read-only page is mapped
+ *		write-protected, so writing it raises a write-protect fault.
+ *		The kernel suspends the faulting thread and hands the fault to
+ *		the service thread, which runs the fault handler outside of
+ *		signal context and wakes the thread once it is resolved.
+ *
+ *		The backing memory stays in the page cache of the shared memory
+ *		object, so mapping a page again is a UFFDIO_CONTINUE without
+ *		copying any data.
+ */
+class userfault_service
+{
+	private:
+		/** @brief type of the fault handler */
+		using fault_handler = void (*)(void*);
+
+		/** @brief The size of a hardware memory page */
+		static const std::size_t page_size = 4096;
+
+		/** @brief The faults read at once */
+		static const int batch_size = 16;
+
+		/** @brief The userfaultfd file descriptor */
+		int _fd;
+
+		/** @brief The start of the registered memory */
+		char* _start;
+
+		/** @brief The size of the registered memory in bytes */
+		std::size_t _size;
+
+		/** @brief Resolves the fault at an address */
+		fault_handler _handle;
+
+		/** @brief Set to stop the service thread */
+		std::atomic<bool> _stop;
+
+		/** @brief The service thread */
+		std::thread _thread;
+
+		/**
+		 * @brief	Throws the error of a failed system call
+		 * @param what	Description of the failed call
+		 */
+		[[noreturn]] static void fail(const std::string& what) {
+			throw std::system_error(errno, std::generic_category(), "ArgoDSM userfaultfd: " + what);
+		}
+
+		/**
+		 * @brief	Issues an ioctl on the userfaultfd, retrying while the mappings change
+		 * @param request	The ioctl request
+		 * @param arg	The argument of the request
+		 * @return	The result of the ioctl
+		 */
+		int control(unsigned long request, void* arg) {
+			int r;
+			while((r = ioctl(_fd, request, arg)) == -1 && errno == EAGAIN) {}
+			return r;
+		}
+
+		/**
+		 * @brief	Registers a range for all fault types
+		 * @param addr	The start of the range
+		 * @param size	The size of the range in bytes
+		 * @note	Mappings replacing registered memory are not registered.
+		 */
+		void register_range(void* addr, std::size_t size) {
+			uffdio_register reg{};
+			reg.range.start = reinterpret_cast<std::uintptr_t>(addr);
+			reg.range.len = size;
+			reg.mode = UFFDIO_REGISTER_MODE_MISSING | UFFDIO_REGISTER_MODE_MINOR |
+				UFFDIO_REGISTER_MODE_WP;
+			if(control(UFFDIO_REGISTER, &reg) == -1) {
+				fail("could not register the global memory");
+			}
+		}
+
+		/**
+		 * @brief	Maps the backing pages of a range, without waking faulting threads
+		 * @param addr	The start of the range
+		 * @param size	The size of the range in bytes
+		 */
+		void continue_range(void* addr, std::size_t size) {
+			uffdio_continue cont{};
+			cont.range.start = reinterpret_cast<std::uintptr_t>(addr);
+			cont.range.len = size;
+			cont.mode = UFFDIO_CONTINUE_MODE_DONTWAKE;
+			if(control(UFFDIO_CONTINUE, &cont) == -1 && errno != EEXIST) {
+				fail("could not map the backing memory");
+			}
+		}
+
+		/**
+		 * @brief	Write-protects a mapped range
+		 * @param addr	The start of the range
+		 * @param size	The size of the range in bytes
+		 */
+		void write_protect(void* addr, std::size_t size) {
+			uffdio_writeprotect wp{};
+			wp.range.start = reinterpret_cast<std::uintptr_t>(addr);
+			wp.range.len = size;
+			wp.mode = UFFDIO_WRITEPROTECT_MODE_WP;
+			if(control(UFFDIO_WRITEPROTECT, &wp) == -1) {
+				fail("could not write-protect the global memory");
+			}
+		}
+
+		/**
+		 * @brief	Wakes the threads waiting for a faulting page
+		 * @param addr	An address in the page
+		 */
+		void wake(std::uintptr_t addr) {
+			uffdio_range range;
+			range.start = addr & ~(page_size - 1);
+			range.len = page_size;
+			control(UFFDIO_WAKE, &range);
+		}
+
+		/** @brief Resolves faults until stopped */
+		void run() {
+			uffd_msg messages[batch_size];
+			pollfd pfd{_fd, POLLIN, 0};
+			while(!_stop.load(std::memory_order_relaxed)) {
+				/* the timeout only bounds the time to notice a stop */
+				if(poll(&pfd, 1, 10) <= 0) {
+					continue;
+				}
+				const ssize_t bytes = read(_fd, messages, sizeof(messages));
+				if(bytes <= 0) {
+					continue;
+				}
+				for(std::size_t i = 0; i < bytes / sizeof(uffd_msg); i++) {
+					if(messages[i].event != UFFD_EVENT_PAGEFAULT) {
+						continue;
+					}
+					const std::uintptr_t addr = messages[i].arg.pagefault.address;
+					_handle(reinterpret_cast<void*>(addr));
+					wake(addr);
+				}
+			}
+		}
+
+	public:
+		/**
+		 * @brief	Registers the global memory and starts the service thread
+		 * @param start	The start of the global memory
+		 * @param size	The size of the global memory in bytes
+		 * @param handle	Resolves the fault at an address, as the
+		 *		SIGSEGV handler would
+		 * @throws std::system_error if the kernel does not support
+		 *         userfaultfd on shared memory
+		 */
+		userfault_service(void* start, std::size_t size, fault_handler handle)
+			: _start(static_cast<char*>(start)), _size(size), _handle(handle), _stop(false) {
+			_fd = syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+			if(_fd == -1) {
+				fail("userfaultfd is not available");
+			}
+			const std::uint64_t features = UFFD_FEATURE_MISSING_SHMEM | UFFD_FEATURE_MINOR_SHMEM |
+				UFFD_FEATURE_WP_HUGETLBFS_SHMEM;
+			uffdio_api api{};
+			api.api = UFFD_API;
+			api.features = features;
+			if(control(UFFDIO_API, &api) == -1 || (api.features & features) != features) {
+				close(_fd);
+				errno = ENOTSUP;
+				fail("faults on shared memory are not supported, Linux 5.19+ is required");
+			}
+			/* access is controlled through the page tables only */
+			if(mprotect(_start, _size, PROT_READ|PROT_WRITE)) {
+				fail("could not unprotect the global memory");
+			}
+			register_range(_start, _size);
+			_thread = std::thread(&userfault_service::run, this);
+		}
+
+		/**
+		 * @brief	Stops the service thread and unregisters the global memory
+		 * @note	Afterwards, all pages of the global memory are accessible.
+		 */
+		~userfault_service() {
+			_stop = true;
+			_thread.join();
+			uffdio_range range;
+			range.start = reinterpret_cast<std::uintptr_t>(_start);
+			range.len = _size;
+			control(UFFDIO_UNREGISTER, &range);
+			close(_fd);
+		}
+
+		/** @brief Copy constructor is not allowed */
+		userfault_service(const userfault_service&) = delete;
+		/** @brief Copy assignment is not allowed */
+		userfault_service& operator=(const userfault_service&) = delete;
+
+		/**
+		 * @brief	Changes the access to a range of the global memory
+		 * @param addr	The start of the range
+		 * @param size	The size of the range in bytes
+		 * @param prot	The access as for mprotect
+		 * @details	The page table entries are dropped, so that further
+		 *		accesses fault, and mapped again if the access allows.
+		 *		The backing memory is not changed.
+		 */
+		void protect(void* addr, std::size_t size, int prot) {
+			if(madvise(addr, size, MADV_DONTNEED)) {
+				fail("could not drop the mapping of the global memory");
+			}
+			if(prot & PROT_READ) {
+				continue_range(addr, size);
+				if(!(prot & PROT_WRITE)) {
+					write_protect(addr, size);
+				}
+			}
+		}
+
+		/**
+		 * @brief	Maps backing memory into the global memory
+		 * @param addr	The address to map to
+		 * @param size	The size of the mapping
+		 * @param offset	The offset into the backing memory
+		 * @param prot	The access as for mprotect
+		 * @see	argo::virtual_memory::map_memory
+		 */
+		void map(void* addr, std::size_t size, std::size_t offset, int prot) {
+			argo::virtual_memory::map_memory(addr, size, offset, PROT_READ|PROT_WRITE);
+			register_range(addr, size);
+			protect(addr, size, prot);
+		}
+};
+
+#endif /* argo_userfault_hpp */
@@ -165,7 +165,7 @@ class write_buffer
 						argo::virtual_memory::start_address()) + page_address;
 
 				// Write back the page
-				mprotect(page_ptr, block_size, PROT_READ);
+				argo_protect_memory(page_ptr, block_size, PROT_READ);
 				cacheControl[cache_index].dirty=CLEAN;
 				for(int i=0; i < CACHELINE; i++){
 					storepageDIFF(cache_index+i,page_size*i+page_address);
@@ -259,7 +259,7 @@ class write_buffer
 						argo::virtual_memory::start_address()) + page_address;
 
 				// Write back the page
-				mprotect(page_ptr, block_size, PROT_READ);
+				argo_protect_memory(page_ptr, block_size, PROT_READ);
 				cacheControl[cache_index].dirty=CLEAN;
 				for(int i=0; i < CACHELINE; i++){
 					storepageDIFF(cache_index+i,page_size*i+page_address);
@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @brief This file provides the local application of reduction operations
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_backend_reduction_hpp
+#define argo_backend_reduction_hpp argo_backend_reduction_hpp
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../types/types.hpp"
+
+namespace argo {
+	namespace backend {
+		/**
+		 * @brief combine two integer values
+		 * @param op the operation to apply
+		 * @param a the first operand
+		 * @param b the second operand
+		 * @tparam T an integer type
+		 * @return the result of applying op to a and b
+		 */
+		template<typename T>
+		typename std::enable_if<std::is_integral<T>::value, T>::type
+		apply_reduction(reduction_op op, T a, T b) {
+			switch (op) {
+				case reduction_op::sum:
+					return a + b;
+				case reduction_op::min:
+					return std::min(a, b);
+				case reduction_op::max:
+					return std::max(a, b);
+				case reduction_op::bitwise_and:
+					return a & b;
+				case reduction_op::bitwise_or:
+					return a | b;
+				case reduction_op::bitwise_xor:
+					return a ^ b;
+			}
+			throw std::invalid_argument("Invalid reduction operation");
+		}
+
+		/**
+		 * @brief combine two floating point values
+		 * @param op the operation to apply, which must not be a bitwise one
+		 * @param a the first operand
+		 * @param b the second operand
+		 * @tparam T a floating point type
+		 * @return the result of applying op to a and b
+		 */
+		template<typename T>
+		typename std::enable_if<std::is_floating_point<T>::value, T>::type
+		apply_reduction(reduction_op op, T a, T b) {
+			switch (op) {
+				case reduction_op::sum:
+					return a + b;
+				case reduction_op::min:
+					return std::min(a, b);
+				case reduction_op::max:
+					return std::max(a, b);
+				default:
+					throw std::invalid_argument(
+						"Bitwise operations are only defined for integer types");
+			}
+		}
+	} // namespace backend
+} // namespace argo
+
+#endif /* argo_backend_reduction_hpp */
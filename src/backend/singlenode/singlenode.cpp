@@ -10,6 +10,7 @@
 #include "types/types.hpp"
 #include "virtual_memory/virtual_memory.hpp"
 #include "../backend.hpp"
+#include "../reduction.hpp"
 
 #include <atomic>
 #include <condition_variable>
@@ -17,10 +18,27 @@
 #include <cstddef>
 #include <cstring>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace vm = argo::virtual_memory;
 namespace sig = argo::signal;
 
+/**
+ * @brief combine an object in memory with a value
+ * @param obj pointer to the object
+ * @param op the operation to apply
+ * @param value pointer to the value
+ * @param output_buffer where to store the old value of the object
+ * @tparam T the type of the object and value
+ */
+template<typename T>
+static void fetch_op_as(void* obj, argo::reduction_op op, const void* value, void* output_buffer) {
+	T* ptr = static_cast<T*>(obj);
+	std::memcpy(output_buffer, ptr, sizeof(T));
+	*ptr = argo::backend::apply_reduction(op, *ptr, *static_cast<const T*>(value));
+}
+
 /** @brief a lock for atomically executed operations */
 std::mutex atomic_op_mutex;
 
@@ -39,6 +57,15 @@ std::atomic<bool> barrier_flag{false};
 /** @brief scoped locking type */
 using lock_guard = std::lock_guard<std::mutex>;
 
+/** @brief a lock for combining the values of a reduction */
+std::mutex reduction_mutex;
+
+/** @brief the value of the ongoing reduction, large enough for any reduced type */
+alignas(16) char reduction_value[16];
+
+/** @brief the number of threads holding a part in the ongoing reduction */
+std::size_t reduction_contributors = 0;
+
 /** @brief the only valid ArgoDSM node id */
 const argo::node_id_t my_node_id = 0;
 
@@ -57,10 +84,46 @@ char* memory;
  */
 std::size_t memory_size;
 
+/**
+ * @brief check that a local buffer is not part of the global memory
+ * @param buffer the local buffer
+ * @param size the size of the buffer in bytes
+ * @throws std::invalid_argument if the buffer overlaps the global memory
+ */
+static void check_local(const void* buffer, std::size_t size) {
+	const char* b = static_cast<const char*>(buffer);
+	if(b < memory + memory_size && b + size > memory) {
+		throw std::invalid_argument("The local buffer must not be in the global memory");
+	}
+}
+
+/**
+ * @brief check that a range is part of the global memory
+ * @param range the start of the range
+ * @param size the size of the range in bytes
+ * @throws std::invalid_argument if the range is not inside the global memory
+ */
+static void check_global(const void* range, std::size_t size) {
+	const char* r = static_cast<const char*>(range);
+	if(r < memory || static_cast<std::size_t>(r - memory) > memory_size ||
+			size > memory_size - static_cast<std::size_t>(r - memory)) {
+		throw std::invalid_argument("The range must be in the global memory");
+	}
+}
+
+/** @brief the registered functions to run at the home node */
+std::unordered_map<void (*)(), argo::backend::home_function> home_functions;
+
+/** @brief serializes the functions run at the home node */
+std::mutex home_functions_mutex;
+
 /*First-Touch policy*/
 /** @brief holds the owner and backing offset of a page */
 std::uintptr_t *global_owners_dir;
 
+/** @brief the lock buffer of the global MCS lock */
+std::size_t lockbuffer[argo::backend::atomic::lockbuffer_words];
+
 /**
  * @brief a dummy signal handler function
  * @warning this function is not strictly portable because it resets the handler and re-raises the signal
@@ -156,6 +219,100 @@ namespace argo {
 			barrier_cv.wait(barrier_lock, []{ return !barrier_flag; });
 		}
 
+		/**
+		 * @brief combine the values of all threads
+		 * @param value the value of the calling thread, replaced by the result
+		 * @param size the size of the value
+		 * @param threadcount the number of threads taking part
+		 * @param combine combines a value into the value of the reduction
+		 */
+		template<typename F>
+		static void local_reduction(void* value, std::size_t size, std::size_t threadcount, F combine) {
+			{
+				lock_guard lock(reduction_mutex);
+				if(reduction_contributors == 0) {
+					memcpy(reduction_value, value, size);
+				} else {
+					combine(value);
+				}
+				reduction_contributors++;
+			}
+			barrier(threadcount);
+			{
+				lock_guard lock(reduction_mutex);
+				memcpy(value, reduction_value, size);
+				reduction_contributors--;
+			}
+			/* no thread may start the next reduction before all have the result */
+			barrier(threadcount);
+		}
+
+		void _allreduce_int(void* value, reduction_op op, std::size_t size, std::size_t threadcount) {
+			local_reduction(value, size, threadcount, [&](void* v) {
+				alignas(16) char old[16];
+				switch (size) {
+					case 1: fetch_op_as<int8_t>(reduction_value, op, v, old); break;
+					case 2: fetch_op_as<int16_t>(reduction_value, op, v, old); break;
+					case 4: fetch_op_as<int32_t>(reduction_value, op, v, old); break;
+					case 8: fetch_op_as<int64_t>(reduction_value, op, v, old); break;
+					default:
+						throw std::invalid_argument(
+							"Invalid size (must be either 1, 2, 4 or 8)");
+				}
+			});
+		}
+
+		void _allreduce_uint(void* value, reduction_op op, std::size_t size, std::size_t threadcount) {
+			local_reduction(value, size, threadcount, [&](void* v) {
+				alignas(16) char old[16];
+				switch (size) {
+					case 1: fetch_op_as<uint8_t>(reduction_value, op, v, old); break;
+					case 2: fetch_op_as<uint16_t>(reduction_value, op, v, old); break;
+					case 4: fetch_op_as<uint32_t>(reduction_value, op, v, old); break;
+					case 8: fetch_op_as<uint64_t>(reduction_value, op, v, old); break;
+					default:
+						throw std::invalid_argument(
+							"Invalid size (must be either 1, 2, 4 or 8)");
+				}
+			});
+		}
+
+		void _allreduce_float(void* value, reduction_op op, std::size_t size, std::size_t threadcount) {
+			if (op != reduction_op::sum && op != reduction_op::min && op != reduction_op::max) {
+				throw std::invalid_argument(
+					"Bitwise operations are only defined for integer types");
+			}
+			local_reduction(value, size, threadcount, [&](void* v) {
+				alignas(16) char old[16];
+				switch (size) {
+					case 4: fetch_op_as<float>(reduction_value, op, v, old); break;
+					case 8: fetch_op_as<double>(reduction_value, op, v, old); break;
+					case 16: fetch_op_as<long double>(reduction_value, op, v, old); break;
+					default:
+						throw std::invalid_argument(
+							"Invalid size (must be either 4, 8 or 16)");
+				}
+			});
+		}
+
+		void _reduce_int(void* value, reduction_op op, std::size_t size, node_id_t root,
+				std::size_t threadcount) {
+			(void)root; // root is always node 0
+			_allreduce_int(value, op, size, threadcount);
+		}
+
+		void _reduce_uint(void* value, reduction_op op, std::size_t size, node_id_t root,
+				std::size_t threadcount) {
+			(void)root; // root is always node 0
+			_allreduce_uint(value, op, size, threadcount);
+		}
+
+		void _reduce_float(void* value, reduction_op op, std::size_t size, node_id_t root,
+				std::size_t threadcount) {
+			(void)root; // root is always node 0
+			_allreduce_float(value, op, size, threadcount);
+		}
+
 		template<typename T>
 		void broadcast(node_id_t source, T* ptr) {
 			(void)source; // source is always node 0
@@ -164,12 +321,187 @@ namespace argo {
 
 #		include "../explicit_instantiations.inc.cpp"
 
+		void register_function(void (*fn)(), home_function call) {
+			std::lock_guard<std::mutex> lock(home_functions_mutex);
+			home_functions[fn] = call;
+		}
+
+		void invoke_at_home(void* object, std::size_t object_size, void (*fn)(),
+				const void* arg, std::size_t arg_size, std::size_t result_size,
+				std::function<void(const void*)> done) {
+			(void)arg_size; // the argument is used in place
+			const std::uintptr_t offset = static_cast<char*>(object) - memory;
+			if(object_size > 0 && offset / 4096 != (offset + object_size - 1) / 4096) {
+				throw std::invalid_argument("The object must not cross a page boundary");
+			}
+			/* never empty, as an empty result must not read as a failure */
+			std::vector<char> result(result_size + 1);
+			bool failed = false;
+			{
+				std::lock_guard<std::mutex> lock(home_functions_mutex);
+				auto it = home_functions.find(fn);
+				if(it == home_functions.end()) {
+					throw std::invalid_argument("The function must be registered before it is invoked");
+				}
+				/* the functions run one at a time, as on a home node */
+				try {
+					it->second(fn, object, arg, result.data());
+				} catch(...) {
+					failed = true;
+				}
+			}
+			done(failed ? nullptr : result.data());
+		}
+
+		ticket prefetch(void* addr, std::size_t size) {
+			(void)addr; // all memory is local
+			(void)size;
+			return 0;
+		}
+
+		void advise(void* addr, std::size_t size, advice hints) {
+			(void)addr; // all memory is local, so there is nothing to tune
+			(void)size;
+			(void)hints;
+		}
+
+		bool _is_cached(const void* addr) {
+			(void)addr; // all memory is local
+			return true;
+		}
+
+		bool _is_sharer(const void* addr, node_id_t node) {
+			(void)addr; // there is no directory, as no other node shares pages
+			(void)node;
+			return false;
+		}
+
+		void wait(ticket t) {
+			(void)t; // nothing is ever pending
+		}
+
+		bool test(ticket t) {
+			(void)t; // nothing is ever pending
+			return true;
+		}
+
+		void get(void* dst, const void* src, std::size_t size) {
+			check_local(dst, size);
+			check_global(src, size);
+			std::memcpy(dst, src, size);
+		}
+
+		void put(void* dst, const void* src, std::size_t size) {
+			check_local(src, size);
+			check_global(dst, size);
+			std::memcpy(dst, src, size);
+		}
+
+		void gather(void* dst, const void* base, const std::ptrdiff_t* offsets,
+				std::size_t count, std::size_t size) {
+			check_local(dst, count * size);
+			for(std::size_t i = 0; i < count; i++) {
+				check_global(static_cast<const char*>(base) + offsets[i], size);
+			}
+			for(std::size_t i = 0; i < count; i++) {
+				std::memcpy(static_cast<char*>(dst) + i * size,
+						static_cast<const char*>(base) + offsets[i], size);
+			}
+		}
+
+		void scatter(void* base, const void* src, const std::ptrdiff_t* offsets,
+				std::size_t count, std::size_t size) {
+			check_local(src, count * size);
+			for(std::size_t i = 0; i < count; i++) {
+				check_global(static_cast<char*>(base) + offsets[i], size);
+			}
+			for(std::size_t i = 0; i < count; i++) {
+				std::memcpy(static_cast<char*>(base) + offsets[i],
+						static_cast<const char*>(src) + i * size, size);
+			}
+		}
+
+		void fill(void* dst, const void* pattern, std::size_t pattern_size, std::size_t size) {
+			if(pattern_size == 0) {
+				throw std::invalid_argument("The fill pattern must not be empty");
+			}
+			char* d = static_cast<char*>(dst);
+			const char* p = static_cast<const char*>(pattern);
+			for(std::size_t i = 0; i < size; i++) {
+				d[i] = p[i % pattern_size];
+			}
+		}
+
+		void copy(void* dst, const void* src, std::size_t size) {
+			const char* d = static_cast<const char*>(dst);
+			const char* s = static_cast<const char*>(src);
+			if(d < s + size && s < d + size) {
+				throw std::invalid_argument("The ranges of a copy must not overlap");
+			}
+			std::memcpy(dst, src, size);
+		}
+
+		void broadcast_range(void* addr, std::size_t size, node_id_t root) {
+			(void)addr; // all memory is local
+			(void)size;
+			if(root != 0) {
+				throw std::invalid_argument("The root of a broadcast must be a node");
+			}
+		}
+
+		void* local_view(void* addr, std::size_t size, bool write) {
+			(void)write; // all memory is local
+			return (size == 0) ? nullptr : addr;
+		}
+
+		ticket get_async(void* dst, const void* src, std::size_t size) {
+			get(dst, src, size);
+			return 0;
+		}
+
+		ticket put_async(void* dst, const void* src, std::size_t size) {
+			put(dst, src, size);
+			return 0;
+		}
+
 		void acquire() {
 			std::atomic_thread_fence(std::memory_order_acquire);
 		}
 		void release() {
 			std::atomic_thread_fence(std::memory_order_release);
 		}
+		ticket release_async() {
+			release();
+			return 0;
+		}
+
+		team_handle team_create(const node_id_t* members, std::size_t count) {
+			if(count != 1 || members[0] != 0) {
+				throw std::invalid_argument("The team members must be nodes");
+			}
+			return 0;
+		}
+		void team_free(team_handle team) {
+			(void)team; // there is only one team
+		}
+		void team_barrier(team_handle team, std::size_t threadcount) {
+			(void)team; // the team is this node
+			barrier(threadcount);
+		}
+		void _team_broadcast(team_handle team, node_id_t source, void* ptr, std::size_t size) {
+			(void)team; // the team is this node
+			(void)source; // source is always node 0
+			(void)ptr; // synchronization with self is a no-op
+			(void)size;
+		}
+		void team_acquire(team_handle team) {
+			(void)team; // the team is this node
+			acquire();
+		}
+		void team_release(team_handle team) {
+			(void)team; // the team is this node
+			release();
+		}
 		void _selective_acquire(void* addr, std::size_t size) {
 			(void)addr;
 			(void)size;
@@ -180,6 +512,16 @@ namespace argo {
 			(void)size;
 			release();	// Selective release not actually possible here
 		}
+		void _selective_acquire(const memory_range* ranges, std::size_t count) {
+			(void)ranges;
+			(void)count;
+			acquire();	// Selective acquire not actually possible here
+		}
+		void _selective_release(const memory_range* ranges, std::size_t count) {
+			(void)ranges;
+			(void)count;
+			release();	// Selective release not actually possible here
+		}
 
 		namespace atomic {
 			void _exchange(global_ptr<void> obj, void* desired,
@@ -216,6 +558,13 @@ namespace argo {
 				(void)disp;
 			}
 
+			void _store_lockbuffer(const std::size_t desired,
+					const node_id_t rank, const std::size_t disp) {
+				(void)rank;
+				lock_guard lock(atomic_op_mutex);
+				lockbuffer[disp] = desired;
+			}
+
 			void _load(
 					global_ptr<void> obj, std::size_t size, void* output_buffer) {
 				lock_guard lock(atomic_op_mutex);
@@ -247,6 +596,16 @@ namespace argo {
 				(void)disp;
 			}
 
+			void _load_local_lockbuffer(std::size_t* output_buffer,
+					const std::size_t disp) {
+				lock_guard lock(atomic_op_mutex);
+				*output_buffer = lockbuffer[disp];
+			}
+
+			const volatile std::size_t* _local_lockbuffer_word(const std::size_t disp) {
+				return &lockbuffer[disp];
+			}
+
 			void _compare_exchange(global_ptr<void> obj, void* desired,
 					std::size_t size, void* expected, void* output_buffer) {
 				lock_guard lock(atomic_op_mutex);
@@ -391,6 +750,129 @@ namespace argo {
 						break;
 				}
 			}
+
+			void _fetch_op_int(global_ptr<void> obj, reduction_op op, void* value,
+					std::size_t size, void* output_buffer) {
+				lock_guard lock(atomic_op_mutex);
+				switch (size) {
+					case 1: fetch_op_as<int8_t>(obj.get(), op, value, output_buffer); break;
+					case 2: fetch_op_as<int16_t>(obj.get(), op, value, output_buffer); break;
+					case 4: fetch_op_as<int32_t>(obj.get(), op, value, output_buffer); break;
+					case 8: fetch_op_as<int64_t>(obj.get(), op, value, output_buffer); break;
+					default:
+						throw std::invalid_argument(
+							"Invalid size (must be either 1, 2, 4 or 8)");
+				}
+			}
+
+			void _fetch_op_uint(global_ptr<void> obj, reduction_op op, void* value,
+					std::size_t size, void* output_buffer) {
+				lock_guard lock(atomic_op_mutex);
+				switch (size) {
+					case 1: fetch_op_as<uint8_t>(obj.get(), op, value, output_buffer); break;
+					case 2: fetch_op_as<uint16_t>(obj.get(), op, value, output_buffer); break;
+					case 4: fetch_op_as<uint32_t>(obj.get(), op, value, output_buffer); break;
+					case 8: fetch_op_as<uint64_t>(obj.get(), op, value, output_buffer); break;
+					default:
+						throw std::invalid_argument(
+							"Invalid size (must be either 1, 2, 4 or 8)");
+				}
+			}
+
+			void _fetch_op_float(global_ptr<void> obj, reduction_op op, void* value,
+					std::size_t size, void* output_buffer) {
+				lock_guard lock(atomic_op_mutex);
+				switch (size) {
+					case 4: fetch_op_as<float>(obj.get(), op, value, output_buffer); break;
+					case 8: fetch_op_as<double>(obj.get(), op, value, output_buffer); break;
+					case 16: fetch_op_as<long double>(obj.get(), op, value, output_buffer); break;
+					default:
+						throw std::invalid_argument(
+							"Invalid size (must be either 4, 8 or 16)");
+				}
+			}
+
+			void _post_op_int(global_ptr<void> obj, reduction_op op, const void* value,
+					std::size_t size) {
+				char old[16];
+				_fetch_op_int(obj, op, const_cast<void*>(value), size, old);
+			}
+
+			void _post_op_uint(global_ptr<void> obj, reduction_op op, const void* value,
+					std::size_t size) {
+				char old[16];
+				_fetch_op_uint(obj, op, const_cast<void*>(value), size, old);
+			}
+
+			void _post_op_float(global_ptr<void> obj, reduction_op op, const void* value,
+					std::size_t size) {
+				alignas(16) char old[16];
+				_fetch_op_float(obj, op, const_cast<void*>(value), size, old);
+			}
+
+			void _flush_ops() {
+				// operations are complete when issued
+			}
+
+			void _accumulate_int(const global_ptr<void>* segments, const std::size_t* counts,
+					std::size_t num_segments, const void* values, reduction_op op, std::size_t size) {
+				const char* value = static_cast<const char*>(values);
+				for(std::size_t i = 0; i < num_segments; i++) {
+					char* element = static_cast<char*>(segments[i].get());
+					for(std::size_t j = 0; j < counts[i]; j++, element += size, value += size) {
+						_post_op_int(global_ptr<void>(element), op, value, size);
+					}
+				}
+			}
+
+			void _accumulate_uint(const global_ptr<void>* segments, const std::size_t* counts,
+					std::size_t num_segments, const void* values, reduction_op op, std::size_t size) {
+				const char* value = static_cast<const char*>(values);
+				for(std::size_t i = 0; i < num_segments; i++) {
+					char* element = static_cast<char*>(segments[i].get());
+					for(std::size_t j = 0; j < counts[i]; j++, element += size, value += size) {
+						_post_op_uint(global_ptr<void>(element), op, value, size);
+					}
+				}
+			}
+
+			void _accumulate_float(const global_ptr<void>* segments, const std::size_t* counts,
+					std::size_t num_segments, const void* values, reduction_op op, std::size_t size) {
+				const char* value = static_cast<const char*>(values);
+				for(std::size_t i = 0; i < num_segments; i++) {
+					char* element = static_cast<char*>(segments[i].get());
+					for(std::size_t j = 0; j < counts[i]; j++, element += size, value += size) {
+						_post_op_float(global_ptr<void>(element), op, value, size);
+					}
+				}
+			}
+
+			void _fetch_add_many_int(const global_ptr<void>* objs, const void* values,
+					std::size_t count, std::size_t size, void* output_buffer) {
+				const char* value = static_cast<const char*>(values);
+				char* output = static_cast<char*>(output_buffer);
+				for(std::size_t i = 0; i < count; i++) {
+					_fetch_add_int(objs[i], const_cast<char*>(value + i*size), size, output + i*size);
+				}
+			}
+
+			void _fetch_add_many_uint(const global_ptr<void>* objs, const void* values,
+					std::size_t count, std::size_t size, void* output_buffer) {
+				const char* value = static_cast<const char*>(values);
+				char* output = static_cast<char*>(output_buffer);
+				for(std::size_t i = 0; i < count; i++) {
+					_fetch_add_uint(objs[i], const_cast<char*>(value + i*size), size, output + i*size);
+				}
+			}
+
+			void _fetch_add_many_float(const global_ptr<void>* objs, const void* values,
+					std::size_t count, std::size_t size, void* output_buffer) {
+				const char* value = static_cast<const char*>(values);
+				char* output = static_cast<char*>(output_buffer);
+				for(std::size_t i = 0; i < count; i++) {
+					_fetch_add_float(objs[i], const_cast<char*>(value + i*size), size, output + i*size);
+				}
+			}
 		} // namespace atomic
 
 	} // namespace backend
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief This file implements explicit coherence facilities for ArgoDSM
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#include "coherence.hpp"
+
+namespace argo {
+	ticket prefetch(void* addr, std::size_t size) {
+		return backend::prefetch(addr, size);
+	}
+
+	ticket release_async() {
+		return backend::release_async();
+	}
+
+	void advise(void* addr, std::size_t size, advice hints) {
+		backend::advise(addr, size, hints);
+	}
+
+	void wait(ticket t) {
+		backend::wait(t);
+	}
+
+	bool test(ticket t) {
+		return backend::test(t);
+	}
+} // namespace argo
+
+extern "C" {
+	argo_ticket_t argo_prefetch(void* addr, size_t size) {
+		return argo::prefetch(addr, size);
+	}
+
+	argo_ticket_t argo_release_async() {
+		return argo::release_async();
+	}
+
+	void argo_advise(void* addr, size_t size, unsigned int hints) {
+		argo::advise(addr, size, static_cast<argo::advice>(hints));
+	}
+
+	void argo_wait(argo_ticket_t ticket) {
+		argo::wait(ticket);
+	}
+
+	int argo_test(argo_ticket_t ticket) {
+		return argo::test(ticket);
+	}
+}
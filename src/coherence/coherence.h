@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @brief This file provides C bindings for the ArgoDSM coherence facilities
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_coherence_h
+#define argo_coherence_h argo_coherence_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief handle to wait for an asynchronous operation with
+ */
+typedef uint64_t argo_ticket_t;
+
+/**
+ * @brief start loading a range of the global memory into the local cache
+ * @param addr the start of the range
+ * @param size the size of the range in bytes
+ * @return a ticket to wait for the prefetch with
+ * @details returns right away, the range is loaded in the background
+ */
+argo_ticket_t argo_prefetch(void* addr, size_t size);
+
+/**
+ * @brief start propagating the writes of this node in the background
+ * @return a ticket to wait for the release with
+ * @see argo::release_async
+ */
+argo_ticket_t argo_release_async(void);
+
+/**
+ * @brief hints on how a region of the global memory is accessed
+ * @details The hints can be combined with |.
+ * @see argo::advice
+ */
+enum argo_advice {
+	ARGO_ADVICE_NORMAL = 0, /**< No special treatment */
+	ARGO_ADVICE_READ_ONLY = 1, /**< Not written by any node while advised */
+	ARGO_ADVICE_NODE_PRIVATE = 2, /**< Only accessed by the advising node while advised */
+	ARGO_ADVICE_SEQUENTIAL = 4, /**< Accessed in increasing address order */
+	ARGO_ADVICE_RANDOM = 8, /**< Accessed in no particular order */
+	ARGO_ADVICE_WRITE_ONCE = 16, /**< Each page written by at most one node between synchronizations */
+};
+
+/**
+ * @brief tune the coherence of a range of the global memory to how it is accessed
+ * @param addr the start of the range
+ * @param size the size of the range in bytes
+ * @param hints the argo_advice hints, replacing earlier hints
+ * @see argo::advise
+ */
+void argo_advise(void* addr, size_t size, unsigned int hints);
+
+/**
+ * @brief wait until an asynchronous operation has completed
+ * @param ticket the ticket of the operation
+ */
+void argo_wait(argo_ticket_t ticket);
+
+/**
+ * @brief check whether an asynchronous operation has completed
+ * @param ticket the ticket of the operation
+ * @return nonzero if the operation has completed
+ */
+int argo_test(argo_ticket_t ticket);
+
+#endif /* argo_coherence_h */
@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @brief This file provides explicit coherence facilities for ArgoDSM
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_coherence_hpp
+#define argo_coherence_hpp argo_coherence_hpp
+
+#include <cstddef>
+
+#include "../backend/backend.hpp"
+
+namespace argo {
+	/**
+	 * @brief handle to wait for an asynchronous operation with
+	 * @details Operations complete in the order they are started on a node,
+	 *          so waiting for an operation also waits for all operations
+	 *          started before it on the same node.
+	 */
+	using ticket = backend::ticket;
+
+	/**
+	 * @brief start loading a range of the global memory into the local cache
+	 * @param addr the start of the range
+	 * @param size the size of the range in bytes
+	 * @return a ticket to wait for the prefetch with
+	 * @details This returns right away, and the range is loaded in the
+	 *          background. Accessing the range before the prefetch has
+	 *          completed is allowed, and faults in the accessed pages as
+	 *          usual. Prefetched data is as coherent as data read at the
+	 *          time it is loaded, and a following acquire may invalidate it.
+	 * @note Prefetching a range larger than the cache evicts parts of it.
+	 */
+	ticket prefetch(void* addr, std::size_t size);
+
+	/**
+	 * @brief start propagating the writes of this node in the background
+	 * @return a ticket to wait for the release with
+	 * @details This returns right away, and the writes made before the call
+	 *          are written back to their home nodes by a worker thread.
+	 *          Other nodes are guaranteed to see them once the release has
+	 *          completed, e.g. after argo::wait() on the ticket. The next
+	 *          acquire, barrier or allreduce of this node waits for the
+	 *          release to complete.
+	 * @note Writes made while the release runs may be written back by it
+	 *       too, but are only guaranteed to be released by a later release.
+	 */
+	ticket release_async();
+
+	/**
+	 * @brief tune the coherence of a range of the global memory to how it is accessed
+	 * @param addr the start of the range
+	 * @param size the size of the range in bytes
+	 * @param hints how the range is accessed, replacing earlier hints
+	 * @details The hints apply to every page overlapping the range, on the
+	 *          calling node only, until they are replaced or the memory is
+	 *          reset:
+	 *          - advice::read_only pages are kept in the cache across
+	 *            acquires. Advise them after synchronizing with their last
+	 *            writer, and advise them again before writing them.
+	 *          - advice::node_private pages are accessed without keeping
+	 *            track of the nodes sharing them, and are kept across
+	 *            acquires. No other node may access them while advised,
+	 *            and other nodes drop their copies at their next acquire.
+	 *          - advice::sequential pages are prefetched ahead of a miss.
+	 *          - advice::random pages are loaded without prefetching the
+	 *            following page.
+	 *          - advice::write_once pages are written back whole instead
+	 *            of comparing them with a copy taken before the first
+	 *            write. No other node may write them between two
+	 *            synchronizations of the writing node.
+	 * @note Hints that break their promises make accesses read stale data
+	 *       or lose writes. Changing the read_only, node_private or
+	 *       write_once hints of a page writes back and drops its cached
+	 *       copy on the calling node.
+	 */
+	void advise(void* addr, std::size_t size, advice hints);
+
+	/**
+	 * @brief wait until an asynchronous operation has completed
+	 * @param t the ticket of the operation
+	 */
+	void wait(ticket t);
+
+	/**
+	 * @brief check whether an asynchronous operation has completed
+	 * @param t the ticket of the operation
+	 * @return true if the operation has completed
+	 */
+	bool test(ticket t);
+} // namespace argo
+
+extern "C" {
+#include "coherence.h"
+}
+
+#endif /* argo_coherence_hpp */
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief This file provides element-wise accumulation into global arrays
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_communication_accumulate_hpp
+#define argo_communication_accumulate_hpp argo_communication_accumulate_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../backend/backend.hpp"
+#include "../data_distribution/global_ptr.hpp"
+#include "../types/types.hpp"
+
+namespace argo {
+	/**
+	 * @brief combine a local array element-wise into a global array
+	 * @tparam T the type of the array elements
+	 * @param dst the first element of the global array
+	 * @param src the local values to combine the global elements with
+	 * @param n the number of elements
+	 * @param op the operation to apply, dst[i] = op(dst[i], src[i])
+	 * @details The global range is split into one contiguous part per
+	 *          home node, and each part is applied as a single remote
+	 *          operation. The update of each element is atomic with respect
+	 *          to all other atomic operations, but the update of the whole
+	 *          range is not. All updates are complete on return.
+	 * @note The updates are relaxed. To read the results through plain
+	 *       global memory accesses, synchronize with the updating nodes,
+	 *       e.g. through a barrier.
+	 * @throws std::invalid_argument if dst is not suitably aligned for T,
+	 *         or op is a bitwise operation on a floating point type
+	 */
+	template<typename T>
+	void accumulate(data_distribution::global_ptr<T> dst, const T* src, std::size_t n,
+			reduction_op op = reduction_op::sum) {
+		static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type");
+		static_assert(data_distribution::granularity % sizeof(T) == 0,
+			"elements must not cross page boundaries");
+		using data_distribution::granularity;
+
+		char* addr = reinterpret_cast<char*>(dst.get());
+		char* const end = addr + n * sizeof(T);
+		if(reinterpret_cast<std::uintptr_t>(addr) % sizeof(T) != 0) {
+			throw std::invalid_argument("The global array must be aligned to its element size");
+		}
+
+		/* find the contiguous parts of the range on each home node */
+		std::vector<data_distribution::global_ptr<void>> segments;
+		std::vector<std::size_t> counts;
+		std::size_t last_end = 0;
+		while(addr < end) {
+			char* page_end = reinterpret_cast<char*>(
+					(reinterpret_cast<std::uintptr_t>(addr) / granularity + 1) * granularity);
+			char* part_end = (page_end < end) ? page_end : end;
+			data_distribution::global_ptr<char> part(addr);
+			std::size_t elements = (part_end - addr) / sizeof(T);
+			if(!segments.empty() && segments.back().node() == part.node() &&
+					last_end == part.offset()) {
+				counts.back() += elements;
+			} else {
+				segments.emplace_back(part);
+				counts.push_back(elements);
+			}
+			last_end = part.offset() + elements * sizeof(T);
+			addr = part_end;
+		}
+
+		// The order is important here, as floats are signed as well
+		if(std::is_floating_point<T>::value) {
+			backend::atomic::_accumulate_float(segments.data(), counts.data(), segments.size(), src, op, sizeof(T));
+		} else if(std::is_unsigned<T>::value) {
+			backend::atomic::_accumulate_uint(segments.data(), counts.data(), segments.size(), src, op, sizeof(T));
+		} else {
+			backend::atomic::_accumulate_int(segments.data(), counts.data(), segments.size(), src, op, sizeof(T));
+		}
+	}
+
+	/**
+	 * @brief combine a local array element-wise into a global array
+	 * @tparam T the type of the array elements
+	 * @param dst the first element of the global array
+	 * @param src the local values to combine the global elements with
+	 * @param n the number of elements
+	 * @param op the operation to apply, dst[i] = op(dst[i], src[i])
+	 * @see accumulate(data_distribution::global_ptr<T>, const T*, std::size_t, reduction_op)
+	 */
+	template<typename T>
+	void accumulate(T* dst, const T* src, std::size_t n, reduction_op op = reduction_op::sum) {
+		if(n == 0) {
+			return;
+		}
+		accumulate(data_distribution::global_ptr<T>(dst), src, n, op);
+	}
+} // namespace argo
+
+#endif /* argo_communication_accumulate_hpp */
@@ -0,0 +1,88 @@
+/**
+ * @file
+ * @brief This file provides collective operations on global ranges, executed at the home nodes
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_communication_collective_hpp
+#define argo_communication_collective_hpp argo_communication_collective_hpp
+
+#include <cstddef>
+#include <type_traits>
+
+#include "../backend/backend.hpp"
+
+namespace argo {
+	/**
+	 * @brief collectively fill a global array with a value
+	 * @tparam T the type of the array elements
+	 * @param dst the first element of the global array
+	 * @param n the number of elements
+	 * @param value the value to assign to every element
+	 * @details Every node writes the parts of the array homed on it
+	 *          directly into its memory, so no pages are moved between
+	 *          nodes. The call is a barrier, and the values are visible to
+	 *          all nodes when it returns.
+	 * @note Must be called by one thread on every node with the same
+	 *       arguments.
+	 */
+	template<typename T>
+	void fill(T* dst, std::size_t n, const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		backend::fill(dst, &value, sizeof(T), n * sizeof(T));
+	}
+
+	/**
+	 * @brief collectively set a global range to a byte value
+	 * @param dst the start of the range
+	 * @param c the byte value
+	 * @param size the size of the range in bytes
+	 * @see fill()
+	 */
+	inline void memset(void* dst, int c, std::size_t size) {
+		const unsigned char byte = static_cast<unsigned char>(c);
+		backend::fill(dst, &byte, 1, size);
+	}
+
+	/**
+	 * @brief collectively copy a global array
+	 * @tparam T the type of the array elements
+	 * @param dst the first element of the destination array
+	 * @param src the first element of the source array
+	 * @param n the number of elements
+	 * @details Every node copies into the parts of the destination homed
+	 *          on it, reading only the parts of the source homed on other
+	 *          nodes remotely. The call is a barrier, and the copy is
+	 *          visible to all nodes when it returns.
+	 * @note Must be called by one thread on every node with the same
+	 *       arguments.
+	 * @throws std::invalid_argument if the arrays overlap
+	 */
+	template<typename T>
+	void copy(T* dst, const T* src, std::size_t n) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		backend::copy(dst, src, n * sizeof(T));
+	}
+
+	/**
+	 * @brief collectively load a global range into the caches of all nodes
+	 * @param ptr the start of the range
+	 * @param size the size of the range in bytes
+	 * @param root the node whose view of the range is sent to the others
+	 * @details Instead of every node loading the pages of the range from
+	 *          their home nodes, the root reads them once and sends them to
+	 *          all nodes with a collective broadcast. Use this for data all
+	 *          nodes are about to read, such as a lookup table initialized
+	 *          before a barrier. The call synchronizes as a barrier first.
+	 * @note Must be called by one thread on every node with the same
+	 *       arguments. The range must not be written until all nodes have
+	 *       returned. Only as many pages as fit into the cache of a node
+	 *       stay cached there.
+	 * @throws std::invalid_argument if root is not a node
+	 */
+	inline void broadcast_range(void* ptr, std::size_t size, node_id_t root) {
+		backend::broadcast_range(ptr, size, root);
+	}
+} // namespace argo
+
+#endif /* argo_communication_collective_hpp */
@@ -0,0 +1,154 @@
+/**
+ * @file
+ * @brief This file provides near-data execution of functions at the home node of their data
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_communication_invoke_hpp
+#define argo_communication_invoke_hpp argo_communication_invoke_hpp
+
+#include <cstring>
+#include <exception>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../backend/backend.hpp"
+#include "../data_distribution/global_ptr.hpp"
+
+namespace argo {
+	namespace _internal {
+		/**
+		 * @brief Calls a registered function and hands over its result
+		 * @tparam R the result type of the function
+		 * @tparam T the type of the object the function is invoked on
+		 * @tparam A the type of the argument of the function
+		 */
+		template<typename R, typename T, typename A>
+		struct home_call {
+			/** @brief the size of the result in bytes */
+			static std::size_t result_size() {
+				return sizeof(R);
+			}
+
+			/** @brief calls the function at the home node, see backend::home_function */
+			static void call(void (*fn)(), void* object, const void* arg, void* result) {
+				typename std::aligned_storage<sizeof(A), alignof(A)>::type a;
+				std::memcpy(&a, arg, sizeof(A));
+				R r = reinterpret_cast<R (*)(T*, const A&)>(fn)(
+						static_cast<T*>(object), *reinterpret_cast<A*>(&a));
+				std::memcpy(result, &r, sizeof(R));
+			}
+
+			/** @brief fulfills the promise of an invocation with its result */
+			static void fulfill(std::promise<R>& promise, const void* result) {
+				typename std::aligned_storage<sizeof(R), alignof(R)>::type r;
+				std::memcpy(&r, result, sizeof(R));
+				promise.set_value(*reinterpret_cast<R*>(&r));
+			}
+		};
+
+		/**
+		 * @brief Calls a registered function without a result
+		 * @see home_call
+		 */
+		template<typename T, typename A>
+		struct home_call<void, T, A> {
+			/** @brief the size of the result in bytes */
+			static std::size_t result_size() {
+				return 0;
+			}
+
+			/** @brief calls the function at the home node, see backend::home_function */
+			static void call(void (*fn)(), void* object, const void* arg, void* result) {
+				(void)result; // there is no result
+				typename std::aligned_storage<sizeof(A), alignof(A)>::type a;
+				std::memcpy(&a, arg, sizeof(A));
+				reinterpret_cast<void (*)(T*, const A&)>(fn)(
+						static_cast<T*>(object), *reinterpret_cast<A*>(&a));
+			}
+
+			/** @brief fulfills the promise of an invocation */
+			static void fulfill(std::promise<void>& promise, const void* result) {
+				(void)result; // there is no result
+				promise.set_value();
+			}
+		};
+	} // namespace _internal
+
+	/**
+	 * @brief register a function to run at the home node of its object
+	 * @tparam R the result type of the function
+	 * @tparam T the type of the object the function is invoked on
+	 * @tparam A the type of the argument of the function
+	 * @param fn the function
+	 * @note Functions must be registered on all nodes in the same order,
+	 *       before any node invokes them. Registering a function again has
+	 *       no effect.
+	 */
+	template<typename R, typename T, typename A>
+	void register_function(R (*fn)(T*, const A&)) {
+		static_assert(std::is_trivially_copyable<A>::value, "the argument must be trivially copyable");
+		static_assert(std::is_void<R>::value || std::is_trivially_copyable<R>::value,
+			"the result must be trivially copyable");
+		backend::register_function(reinterpret_cast<void (*)()>(fn),
+				&_internal::home_call<R, T, A>::call);
+	}
+
+	/**
+	 * @brief run a registered function on an object at its home node
+	 * @tparam R the result type of the function
+	 * @tparam T the type of the object
+	 * @tparam A the type of the argument of the function
+	 * @tparam U the type of the given argument, which is converted to A
+	 * @param obj the object in the global memory
+	 * @param fn the registered function, called as fn(object, arg)
+	 * @param arg the argument of the function, which is copied
+	 * @return a future for the result of the function
+	 * @details The function is sent to the home node of the object and runs
+	 *          there on the object in the home node's memory, instead of
+	 *          moving the pages of the object to this node. The functions
+	 *          run one at a time on each home node, so updates through them
+	 *          need no locks. The future throws std::runtime_error if the
+	 *          function threw.
+	 * @note The update counts as a write by this node: cached copies on
+	 *       this node are written back and dropped, and other nodes see the
+	 *       update after their next acquire. The function sees the writes
+	 *       of other nodes, and the cached writes of this node, once they
+	 *       have been released. The function must not access the global
+	 *       memory or wait for other invocations.
+	 * @throws std::invalid_argument if fn is not registered, or the object
+	 *         crosses a page boundary
+	 */
+	template<typename R, typename T, typename A, typename U>
+	std::future<R> invoke_at_home(T* obj, R (*fn)(T*, const A&), const U& arg) {
+		static_assert(std::is_trivially_copyable<A>::value, "the argument must be trivially copyable");
+		const A a = arg;
+		auto promise = std::make_shared<std::promise<R>>();
+		std::future<R> result = promise->get_future();
+		backend::invoke_at_home(obj, sizeof(T), reinterpret_cast<void (*)()>(fn),
+				&a, sizeof(A), _internal::home_call<R, T, A>::result_size(),
+				[promise](const void* value) {
+					if(value == nullptr) {
+						promise->set_exception(std::make_exception_ptr(std::runtime_error(
+								"The function invoked at the home node threw an exception")));
+					} else {
+						_internal::home_call<R, T, A>::fulfill(*promise, value);
+					}
+				});
+		return result;
+	}
+
+	/**
+	 * @brief run a registered function on an object at its home node
+	 * @see invoke_at_home(T*, R (*)(T*, const A&), const U&)
+	 */
+	template<typename R, typename T, typename A, typename U>
+	std::future<R> invoke_at_home(data_distribution::global_ptr<T> obj, R (*fn)(T*, const A&),
+			const U& arg) {
+		return invoke_at_home(obj.get(), fn, arg);
+	}
+} // namespace argo
+
+#endif /* argo_communication_invoke_hpp */
@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @brief This file provides bulk one-sided transfers between local and global memory
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_communication_onesided_hpp
+#define argo_communication_onesided_hpp argo_communication_onesided_hpp
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "../backend/backend.hpp"
+#include "../data_distribution/global_ptr.hpp"
+
+namespace argo {
+	/**
+	 * @brief copy a global array into a local buffer
+	 * @tparam T the type of the array elements
+	 * @param dst the local buffer
+	 * @param src the first element of the global array
+	 * @param n the number of elements
+	 * @details The array is split into one contiguous part per home node,
+	 *          and each part is read with a single remote operation
+	 *          without going through the cache. Pages this node holds a
+	 *          valid cached copy of are copied from the cache instead, so
+	 *          the node sees its own writes.
+	 * @note The data is as coherent as a regular read, so synchronize
+	 *       with the writing nodes first, e.g. through a barrier.
+	 * @throws std::invalid_argument if dst is in the global memory, or
+	 *         the array is outside of it
+	 */
+	template<typename T>
+	void get(T* dst, const T* src, std::size_t n) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		backend::get(dst, src, n * sizeof(T));
+	}
+
+	/**
+	 * @brief copy a global array into a local buffer
+	 * @see get(T*, const T*, std::size_t)
+	 */
+	template<typename T>
+	void get(T* dst, data_distribution::global_ptr<T> src, std::size_t n) {
+		get(dst, src.get(), n);
+	}
+
+	/**
+	 * @brief copy a local buffer into a global array
+	 * @tparam T the type of the array elements
+	 * @param dst the first element of the global array
+	 * @param src the local buffer
+	 * @param n the number of elements
+	 * @details The array is split into one contiguous part per home node,
+	 *          and each part is written with a single remote operation
+	 *          without going through the cache. Cached copies of the array
+	 *          on this node are written back and invalidated first.
+	 * @note Other nodes see the data after synchronizing with this node,
+	 *       as for regular writes.
+	 * @throws std::invalid_argument if src is in the global memory, or
+	 *         the array is outside of it
+	 */
+	template<typename T>
+	void put(T* dst, const T* src, std::size_t n) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		backend::put(dst, src, n * sizeof(T));
+	}
+
+	/**
+	 * @brief copy a local buffer into a global array
+	 * @see put(T*, const T*, std::size_t)
+	 */
+	template<typename T>
+	void put(data_distribution::global_ptr<T> dst, const T* src, std::size_t n) {
+		put(dst.get(), src, n);
+	}
+
+	/**
+	 * @brief copy strided elements of a global array into a local buffer
+	 * @tparam T the type of the array elements
+	 * @param dst the local buffer, dst[i] = src[i * stride]
+	 * @param src the first element of the global array
+	 * @param n the number of elements
+	 * @param stride the distance between the elements in units of T,
+	 *               e.g. the row length to read a column of a 2D array
+	 * @details Only the requested elements are transferred, instead of
+	 *          the whole pages holding them. The elements are grouped by
+	 *          home node, and each group is read with a single remote
+	 *          operation. Elements are otherwise read as by get().
+	 * @throws std::invalid_argument if dst is in the global memory, or an
+	 *         element is outside of it or crosses a cache line boundary
+	 */
+	template<typename T>
+	void gather(T* dst, const T* src, std::size_t n, std::ptrdiff_t stride) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		std::vector<std::ptrdiff_t> offsets(n);
+		for(std::size_t i = 0; i < n; i++) {
+			offsets[i] = static_cast<std::ptrdiff_t>(i) * stride * sizeof(T);
+		}
+		backend::gather(dst, src, offsets.data(), n, sizeof(T));
+	}
+
+	/**
+	 * @brief copy indexed elements of a global array into a local buffer
+	 * @tparam T the type of the array elements
+	 * @tparam I the integral type of the indices
+	 * @param dst the local buffer, dst[i] = src[indices[i]]
+	 * @param src the first element of the global array
+	 * @param indices the indices of the elements
+	 * @param n the number of elements
+	 * @see gather(T*, const T*, std::size_t, std::ptrdiff_t)
+	 */
+	template<typename T, typename I>
+	void gather(T* dst, const T* src, const I* indices, std::size_t n) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		static_assert(std::is_integral<I>::value, "indices must be integral");
+		std::vector<std::ptrdiff_t> offsets(n);
+		for(std::size_t i = 0; i < n; i++) {
+			offsets[i] = static_cast<std::ptrdiff_t>(indices[i]) * sizeof(T);
+		}
+		backend::gather(dst, src, offsets.data(), n, sizeof(T));
+	}
+
+	/**
+	 * @brief copy a local buffer into strided elements of a global array
+	 * @tparam T the type of the array elements
+	 * @param dst the first element of the global array, dst[i * stride] = src[i]
+	 * @param src the local buffer
+	 * @param n the number of elements
+	 * @param stride the distance between the elements in units of T,
+	 *               which must not be zero
+	 * @details Only the requested elements are transferred. The elements
+	 *          are grouped by home node, and each group is written with a
+	 *          single remote operation. Elements are otherwise written as
+	 *          by put().
+	 * @throws std::invalid_argument if src is in the global memory, or an
+	 *         element is outside of it or crosses a cache line boundary
+	 */
+	template<typename T>
+	void scatter(T* dst, const T* src, std::size_t n, std::ptrdiff_t stride) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		std::vector<std::ptrdiff_t> offsets(n);
+		for(std::size_t i = 0; i < n; i++) {
+			offsets[i] = static_cast<std::ptrdiff_t>(i) * stride * sizeof(T);
+		}
+		backend::scatter(dst, src, offsets.data(), n, sizeof(T));
+	}
+
+	/**
+	 * @brief copy a local buffer into indexed elements of a global array
+	 * @tparam T the type of the array elements
+	 * @tparam I the integral type of the indices
+	 * @param dst the first element of the global array, dst[indices[i]] = src[i]
+	 * @param src the local buffer
+	 * @param indices the indices of the elements, which must be distinct
+	 * @param n the number of elements
+	 * @see scatter(T*, const T*, std::size_t, std::ptrdiff_t)
+	 */
+	template<typename T, typename I>
+	void scatter(T* dst, const T* src, const I* indices, std::size_t n) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		static_assert(std::is_integral<I>::value, "indices must be integral");
+		std::vector<std::ptrdiff_t> offsets(n);
+		for(std::size_t i = 0; i < n; i++) {
+			offsets[i] = static_cast<std::ptrdiff_t>(indices[i]) * sizeof(T);
+		}
+		backend::scatter(dst, src, offsets.data(), n, sizeof(T));
+	}
+
+	/**
+	 * @brief start copying a global array into a local buffer
+	 * @tparam T the type of the array elements
+	 * @param dst the local buffer
+	 * @param src the first element of the global array
+	 * @param n the number of elements
+	 * @return a ticket to wait for the copy with, see argo::wait()
+	 * @details The local buffer must not be accessed until the copy has
+	 *          completed.
+	 * @see get(T*, const T*, std::size_t)
+	 */
+	template<typename T>
+	backend::ticket get_async(T* dst, const T* src, std::size_t n) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		return backend::get_async(dst, src, n * sizeof(T));
+	}
+
+	/**
+	 * @brief start copying a local buffer into a global array
+	 * @tparam T the type of the array elements
+	 * @param dst the first element of the global array
+	 * @param src the local buffer
+	 * @param n the number of elements
+	 * @return a ticket to wait for the copy with, see argo::wait()
+	 * @details The local buffer must not be modified until the copy has
+	 *          completed.
+	 * @see put(T*, const T*, std::size_t)
+	 */
+	template<typename T>
+	backend::ticket put_async(T* dst, const T* src, std::size_t n) {
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		return backend::put_async(dst, src, n * sizeof(T));
+	}
+} // namespace argo
+
+#endif /* argo_communication_onesided_hpp */
@@ -100,6 +100,36 @@ namespace argo {
 					return homenode;
 				}
 
+				/**
+				 * @brief find the home node of a page without claiming it
+				 * @param ptr address in the page
+				 * @return the home node, or the number of nodes if no node
+				 *         has touched the page yet
+				 */
+				node_id_t touched_homenode (char* const ptr) {
+					std::size_t homenode;
+					static const std::size_t rank = argo::backend::node_id();
+					static const std::size_t global_null = base_distribution<instance>::total_size + 1;
+					const std::size_t addr = (ptr - base_distribution<instance>::start_address) / granularity * granularity;
+					const std::size_t owners_dir_window_index = 3 * (addr / granularity);
+					const std::size_t cas_node = (addr / granularity) % base_distribution<instance>::nodes;
+
+					argo::backend::atomic::_load_local_owners_dir(&homenode, rank, owners_dir_window_index);
+					if (homenode != global_null) {
+						return homenode;
+					}
+					std::size_t page_info[3] = {global_null, global_null, global_null};
+					argo::backend::atomic::_load_public_owners_dir(page_info, sizeof(std::size_t), cas_node, owners_dir_window_index);
+					if (is_all_equal_to(page_info, global_null)) {
+						return base_distribution<instance>::nodes;
+					}
+					/* the page is being claimed, wait for its owner */
+					while (page_info[0] == global_null) {
+						argo::backend::atomic::_load_public_owners_dir(page_info, sizeof(std::size_t), cas_node, owners_dir_window_index);
+					}
+					return page_info[0];
+				}
+
 				virtual std::size_t local_offset (char* const ptr) {
 					std::size_t offset;
 					static const std::size_t rank = argo::backend::node_id();
@@ -89,7 +89,7 @@ namespace argo {
 				 * @brief return the home node of the value pointed to
 				 * @return home node id
 				 */
-				node_id_t node() {
+				node_id_t node() const {
 					return homenode;
 				}
 
@@ -97,7 +97,7 @@ namespace argo {
 				 * @brief return the offset on the home node's local memory share
 				 * @return local offset
 				 */
-				std::size_t offset() {
+				std::size_t offset() const {
 					return local_offset;
 				}
 
@@ -0,0 +1,172 @@
+/**
+ * @file
+ * @brief This file provides owner-computes helpers and direct access based on the data distribution
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_local_ranges_hpp
+#define argo_local_ranges_hpp argo_local_ranges_hpp
+
+#include <cstddef>
+#include <vector>
+
+#include "../backend/backend.hpp"
+#include "data_distribution.hpp"
+#include "first_touch_distribution.hpp"
+#include "global_ptr.hpp"
+#include "naive_distribution.hpp"
+
+namespace argo {
+	/** @brief a range of array indices, [begin, end) */
+	struct index_range {
+		/** @brief the first index of the range */
+		std::size_t begin;
+		/** @brief one past the last index of the range */
+		std::size_t end;
+	};
+
+	namespace data_distribution {
+		/**
+		 * @brief find the node a page should be worked on by
+		 * @param ptr address in the page
+		 * @return the home node of the page
+		 * @note Under the first-touch policy, pages no node has touched yet
+		 *       are not claimed. They are assigned as by the naive policy
+		 *       instead, so that the node working on them claims them.
+		 */
+		inline node_id_t owner_of(char* ptr) {
+			if(is_first_touch_policy()) {
+				node_id_t home = first_touch_distribution<0>().touched_homenode(ptr);
+				if(home != backend::number_of_nodes()) {
+					return home;
+				}
+				return naive_distribution<0>().homenode(ptr);
+			}
+			return global_ptr<char>(ptr, "getHomenode").node();
+		}
+	} // namespace data_distribution
+
+	/**
+	 * @brief find the parts of a global array homed on this node
+	 * @tparam T the type of the array elements
+	 * @param ptr the first element of the global array
+	 * @param n the number of elements
+	 * @return the ranges of indices of the elements homed on this node, in
+	 *         increasing order
+	 * @details An element belongs to the home node of its first byte. The
+	 *          ranges follow the active allocation policy, so working on
+	 *          them keeps the accesses of a node on its own memory.
+	 * @see data_distribution::owner_of for the first-touch policy
+	 */
+	template<typename T>
+	std::vector<index_range> local_ranges(T* ptr, std::size_t n) {
+		using data_distribution::granularity;
+		std::vector<index_range> ranges;
+		if(n == 0) {
+			return ranges;
+		}
+		const node_id_t me = backend::node_id();
+		char* const start = reinterpret_cast<char*>(ptr);
+		char* const end = reinterpret_cast<char*>(ptr + n);
+		char* const base = static_cast<char*>(backend::global_base());
+		for(char* page = base + (start - base) / granularity * granularity; page < end; page += granularity) {
+			if(data_distribution::owner_of(page < start ? start : page) != me) {
+				continue;
+			}
+			/* the elements starting on the page */
+			const std::size_t first = (page <= start) ? 0 :
+				(page - start + sizeof(T) - 1) / sizeof(T);
+			const std::size_t last = (page + granularity >= end) ? n :
+				(page + granularity - start + sizeof(T) - 1) / sizeof(T);
+			if(first >= last) {
+				continue;
+			}
+			if(!ranges.empty() && ranges.back().end == first) {
+				ranges.back().end = last;
+			} else {
+				ranges.push_back({first, last});
+			}
+		}
+		return ranges;
+	}
+
+	/**
+	 * @brief call a function for the indices of a global array homed on this node
+	 * @tparam T the type of the array elements
+	 * @tparam F the type of the function
+	 * @param ptr the first element of the global array
+	 * @param n the number of elements
+	 * @param fn the function, called as fn(i) for every index i homed on
+	 *           this node
+	 * @param thread_id the index of the calling thread on this node
+	 * @param thread_count the number of threads sharing the work on this node
+	 * @details The local indices, as found by local_ranges(), are divided
+	 *          into equal contiguous shares, one per thread. For instance,
+	 *          call this from every thread of an OpenMP parallel region with
+	 *          omp_get_thread_num() and omp_get_num_threads().
+	 */
+	template<typename T, typename F>
+	void for_each_local(T* ptr, std::size_t n, F fn, std::size_t thread_id = 0,
+			std::size_t thread_count = 1) {
+		const std::vector<index_range> ranges = local_ranges(ptr, n);
+		std::size_t total = 0;
+		for(auto& range : ranges) {
+			total += range.end - range.begin;
+		}
+		const std::size_t share_begin = total * thread_id / thread_count;
+		const std::size_t share_end = total * (thread_id + 1) / thread_count;
+		std::size_t position = 0;
+		for(auto& range : ranges) {
+			const std::size_t size = range.end - range.begin;
+			if(position + size > share_begin && position < share_end) {
+				const std::size_t lo = (share_begin > position) ? share_begin - position : 0;
+				const std::size_t hi = (share_end < position + size) ? share_end - position : size;
+				for(std::size_t i = range.begin + lo; i < range.begin + hi; i++) {
+					fn(i);
+				}
+			}
+			position += size;
+		}
+	}
+
+	/**
+	 * @brief get direct access to a part of a global array homed on this node
+	 * @tparam T the type of the array elements
+	 * @param ptr the first element of the part
+	 * @param n the number of elements
+	 * @return a pointer to the elements in the memory of this node, or
+	 *         nullptr if n is zero
+	 * @details Accesses through the view go straight to the home copy of
+	 *          the data, without page faults or coherence bookkeeping. The
+	 *          view is coherent where the global range would be: it sees
+	 *          the writes other nodes have released before this node
+	 *          synchronized with them, e.g. through a barrier, and other
+	 *          nodes see the writes through it after their next acquire
+	 *          that follows a release of this node. Between a barrier and
+	 *          the next one, no other node may write the range.
+	 * @note Writes to the range through the global address of the same
+	 *       node must not be mixed with accesses through the view until a
+	 *       release. Use the const overload for read-only access, which
+	 *       does not register this node as a writer of the range.
+	 * @throws std::invalid_argument if the part is not homed on this node
+	 *         in one contiguous piece of its memory. The ranges returned by
+	 *         local_ranges() are, unless the first-touch policy placed their
+	 *         pages apart.
+	 */
+	template<typename T>
+	T* local_view(T* ptr, std::size_t n) {
+		return static_cast<T*>(backend::local_view(ptr, n * sizeof(T), true));
+	}
+
+	/**
+	 * @brief get read-only direct access to a part of a global array homed on this node
+	 * @see local_view(T*, std::size_t)
+	 */
+	template<typename T>
+	const T* local_view(const T* ptr, std::size_t n) {
+		return static_cast<const T*>(
+				backend::local_view(const_cast<T*>(ptr), n * sizeof(T), false));
+	}
+} // namespace argo
+
+#endif /* argo_local_ranges_hpp */
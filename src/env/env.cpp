@@ -50,6 +50,12 @@ namespace {
 	 */
 	const std::size_t default_allocation_block_size = 1ul<<4; // default: 16
 
+	/**
+	 * @brief default requested pinning policy (if environment variable is unset)
+	 * @see @ref ARGO_PIN_POLICY
+	 */
+	const std::size_t default_pin_policy = 0; // default: pack
+
 	/**
 	 * @brief environment variable used for requesting memory size
 	 * @see @ref ARGO_MEMORY_SIZE
@@ -86,6 +92,12 @@ namespace {
 	 */
 	const std::string env_allocation_block_size = "ARGO_ALLOCATION_BLOCK_SIZE";
 
+	/**
+	 * @brief environment variable used for requesting the pinning policy
+	 * @see @ref ARGO_PIN_POLICY
+	 */
+	const std::string env_pin_policy = "ARGO_PIN_POLICY";
+
 	const std::string env_print_statistics = "ARGO_PRINT_STATISTICS";
 
 	/** @brief error message string */
@@ -126,6 +138,11 @@ namespace {
 	 */
 	std::size_t value_allocation_block_size;
 
+	/**
+	 * @brief pinning policy requested through the environment variable @ref ARGO_PIN_POLICY
+	 */
+	std::size_t value_pin_policy;
+
 	std::size_t value_print_statistics;
 
 	/** @brief flag to allow checking that environment variables have been read before accessing their values */
@@ -185,6 +202,7 @@ namespace argo {
 
 			value_allocation_policy = parse_env(env_allocation_policy, default_allocation_policy).second;
 			value_allocation_block_size = parse_env(env_allocation_block_size, default_allocation_block_size).second;
+			value_pin_policy = parse_env(env_pin_policy, default_pin_policy).second;
 
             value_print_statistics = parse_env(env_print_statistics, 0).second;
 
@@ -221,6 +239,11 @@ namespace argo {
 			return value_allocation_block_size;
 		}
 
+		std::size_t pin_policy() {
+			assert_initialized();
+			return value_pin_policy;
+		}
+
         std::size_t print_statistics() {
 			assert_initialized();
 			return value_print_statistics;
@@ -40,6 +40,12 @@
  * @envvar{ARGO_ALLOCATION_BLOCK_SIZE} request a specific allocation block size in number of pages
  * @details This environment variable can be accessed through
  *          @ref argo::env::allocation_block_size() after argo::env::init() has been called.
+ *
+ * @envvar{ARGO_PIN_POLICY} request a specific thread pinning policy with a number
+ * @details 0 packs threads onto the CPUs of one NUMA domain before moving on to
+ *          the next, 1 spreads consecutive threads over the NUMA domains. This
+ *          environment variable defaults to 0 if not specified. It can be accessed
+ *          through @ref argo::env::pin_policy() after argo::env::init() has been called.
  */
 
 namespace argo {
@@ -97,6 +103,13 @@ namespace argo {
 		 * @see @ref ARGO_ALLOCATION_BLOCK_SIZE
 		 */
 		std::size_t allocation_block_size();
+
+		/**
+		 * @brief get the thread pinning policy requested by environment variable
+		 * @return the requested pinning policy as a number
+		 * @see @ref ARGO_PIN_POLICY
+		 */
+		std::size_t pin_policy();
 		std::size_t  print_statistics();
 	} // namespace env
 } // namespace argo
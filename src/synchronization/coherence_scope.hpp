@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @brief This file provides the coherence scope of ArgoDSM locks
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_coherence_scope_hpp
+#define argo_coherence_scope_hpp argo_coherence_scope_hpp
+
+#include "../backend/backend.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace argo {
+	namespace globallock {
+		/**
+		 * @brief the global memory ranges a lock makes coherent on handover
+		 * @details An empty scope stands for the whole global memory, so the
+		 *          lock performs a full acquire and release. Once ranges are
+		 *          added, only those ranges are selectively acquired and
+		 *          released.
+		 * @warning Writes outside of the scope are not ordered by a lock with
+		 *          a non-empty scope, see backend::selective_acquire().
+		 */
+		class coherence_scope {
+			private:
+				/** @brief the protected ranges */
+				std::vector<backend::memory_range> ranges;
+
+			public:
+				/**
+				 * @brief add a global memory range to the scope
+				 * @param addr the start of the range
+				 * @param size the size of the range in bytes
+				 * @details Handing a lock over between ArgoDSM nodes then only
+				 *          selectively acquires and releases the ranges of its
+				 *          scope. It may be called several times to protect
+				 *          several ranges.
+				 * @warning All nodes must add the same ranges, and only before
+				 *          the lock is used.
+				 */
+				void add(void* addr, std::size_t size) {
+					ranges.push_back({addr, size});
+				}
+
+				/**
+				 * @brief check whether the scope is the whole global memory
+				 * @return true if no ranges have been added
+				 */
+				bool empty() const {
+					return ranges.empty();
+				}
+
+				/** @brief acquire the scope */
+				void acquire() const {
+					if(ranges.empty()) {
+						backend::acquire();
+						return;
+					}
+					backend::selective_acquire(ranges);
+				}
+
+				/** @brief release the scope */
+				void release() const {
+					if(ranges.empty()) {
+						backend::release();
+						return;
+					}
+					backend::selective_release(ranges);
+				}
+		};
+	} // namespace globallock
+} // namespace argo
+
+#endif /* argo_coherence_scope_hpp */
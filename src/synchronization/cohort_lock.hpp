@@ -11,18 +11,14 @@
 #include "../allocators/collective_allocator.hpp"
 #include "../backend/backend.hpp"
 #include "../data_distribution/data_distribution.hpp"
-#include "global_tas_lock.hpp"
+#include "../topology/topology.hpp"
+#include "global_mcs_lock.hpp"
 #include "intranode/mcs_lock.hpp"
 #include "intranode/ticket_lock.hpp"
 
-#include <vector>
-
-#include <sched.h>
-#include <unistd.h>
-
-#ifdef ARGO_USE_LIBNUMA
-#include <numa.h>
-#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
 extern "C" {
 #include "cohort_lock.h"
@@ -30,10 +26,47 @@ extern "C" {
 
 namespace argo {
 	namespace globallock {
+		/**
+		 * @brief contention counters of a cohort lock on one ArgoDSM node
+		 * @note times are in seconds
+		 */
+		struct cohort_lock_statistics {
+			/** @brief number of times the lock was taken on this node */
+			std::size_t acquisitions;
+			/** @brief handovers to a thread in the same NUMA node */
+			std::size_t numa_handovers;
+			/** @brief handovers to a thread in another NUMA node of this ArgoDSM node */
+			std::size_t node_handovers;
+			/** @brief handovers of the global lock to other ArgoDSM nodes */
+			std::size_t global_handovers;
+			/** @brief sum of the number of waiting threads, sampled at each acquisition */
+			std::size_t queue_depth_sum;
+			/** @brief largest number of waiting threads seen at an acquisition */
+			std::size_t max_queue_depth;
+			/** @brief total time threads waited for the lock */
+			double wait_time;
+			/** @brief part of the wait time spent waiting for the global lock */
+			double global_wait_time;
+			/** @brief total time spent in critical sections */
+			double critical_section_time;
+			/** @brief total time spent handing the global lock to other ArgoDSM nodes */
+			double global_handover_time;
+			/** @brief current limit of consecutive handovers within a NUMA node */
+			int max_handover;
+			/** @brief current limit of consecutive handovers between NUMA nodes */
+			int max_handover_nodelock;
+		};
+
 		/**
 		 * @brief a global  'cohort' lock - needs to be called collectively
 		 * @details Locks in levels and tries to hand over the lock as locally
 		 *         as possible.
+		 *
+		 *         How many consecutive local handovers are allowed adapts to
+		 *         the cost of handing the global lock to another ArgoDSM
+		 *         node relative to the length of the critical sections: the
+		 *         more expensive a global handover is, the more local work
+		 *         is done before paying for it.
 		 * @warning Do not allocate this lock on the global memory. It contains
 		 *         data that need to be node local. Also, keep in mind that the
 		 *         constructor calls conew_, so the constructor should be called
@@ -44,7 +77,7 @@ namespace argo {
 		class cohort_lock {
 			private:
 				/** @brief internally used lock type */
-				using global_lock_type = argo::globallock::global_tas_lock;
+				using global_lock_type = argo::globallock::global_mcs_lock;
 
 				/** @brief To keep track if the local ArgoDSM node has the global lock or not */
 				bool has_global_lock;
@@ -64,13 +97,10 @@ namespace argo {
 				/** @brief which node the lock is/was locked in */
 				int node;
 
-				/** @brief Mapping between CPUs and NUMA nodes */
-				std::vector<int> numa_mapping;
-
 				/** @brief Field necessary for the global_lock */
 				global_lock_type::internal_field_type *global_lock_field;
 
-				/** @brief A global TAS lock for locking between ArgoDSM nodes */
+				/** @brief A global MCS lock for locking between ArgoDSM nodes */
 				global_lock_type *global_lock;
 
 				/** @brief Local MCS locks for locking internally on a NUMA node */
@@ -85,6 +115,80 @@ namespace argo {
 				/** @brief maximum amount of local handovers between NUMA nodes on the same ArgoDSM node - numbers are experimental */
 				static const int MAX_HANDOVER_NODELOCK=128;
 
+				/** @brief lower bound for the adaptive limit of handovers within a NUMA node */
+				static const int MIN_HANDOVER=64;
+
+				/** @brief lower bound for the adaptive limit of handovers between NUMA nodes */
+				static const int MIN_HANDOVER_NODELOCK=8;
+
+				/** @brief how many times longer a batch of critical sections should be than a global handover */
+				static constexpr double AMORTIZATION=8.0;
+
+				/** @brief weight of a new sample in the moving averages */
+				static constexpr double EWMA_WEIGHT=0.125;
+
+				/** @brief clock used for the measurements */
+				using clock = std::chrono::steady_clock;
+
+				/** @brief whether the handover limits adapt to the measurements */
+				bool adaptive;
+
+				/** @brief number of threads of this node waiting for the lock */
+				std::atomic<std::size_t> waiting;
+
+				/** @brief when the current critical section started */
+				clock::time_point section_start;
+
+				/** @brief moving average of the critical section time */
+				double avg_section_time;
+
+				/** @brief moving average of the time to hand the global lock over */
+				double avg_handover_time;
+
+				/**
+				 * @brief contention counters and current limits
+				 * @note only updated by the thread holding the lock
+				 */
+				cohort_lock_statistics stats;
+
+				/**
+				 * @brief seconds elapsed between two points in time
+				 * @param from the earlier point in time
+				 * @param to the later point in time
+				 * @return the elapsed time in seconds
+				 */
+				static double seconds(clock::time_point from, clock::time_point to) {
+					return std::chrono::duration<double>(to - from).count();
+				}
+
+				/**
+				 * @brief update a moving average
+				 * @param average the moving average, negative if there is no sample yet
+				 * @param sample the new sample
+				 */
+				static void ewma(double& average, double sample) {
+					average = (average < 0) ? sample : average + EWMA_WEIGHT * (sample - average);
+				}
+
+				/**
+				 * @brief adapt the handover limits to the measured costs
+				 * @details A batch of local handovers should take about
+				 *          AMORTIZATION times as long as handing the global
+				 *          lock to another ArgoDSM node. The limit between
+				 *          NUMA nodes keeps the ratio of the default limits.
+				 */
+				void adapt() {
+					if(!adaptive || avg_section_time <= 0 || avg_handover_time < 0) {
+						return;
+					}
+					double target = AMORTIZATION * avg_handover_time / avg_section_time;
+					target = std::min(std::max(target, double(MIN_HANDOVER)), double(MAX_HANDOVER));
+					stats.max_handover = static_cast<int>(target);
+					stats.max_handover_nodelock = std::min(std::max(
+							stats.max_handover * MAX_HANDOVER_NODELOCK / MAX_HANDOVER,
+							int(MIN_HANDOVER_NODELOCK)), int(MAX_HANDOVER_NODELOCK));
+				}
+
 				/** @brief Constant for no NUMA node having the node_lock */
 				static const int NO_OWNER = -1;
 
@@ -92,17 +196,11 @@ namespace argo {
 				 * @brief Return the NUMA node in which the calling thread is being run.
 				 * @return The NUMA node ID
 				 *
-				 * This function utilizes the sched_getcpu and the
-				 * numa_node_of_cpu function. While the first is very quick, the
-				 * second is extremely slow, so the results are preinitialized
-				 * at the constructor.
+				 * This function utilizes sched_getcpu and the CPU to NUMA node
+				 * mapping of argo::topology, which is detected only once.
 				 */
 				int numa_node() {
-					/*
-					 * int cpu = sched_getcpu();
-					 * return numa_mapping[cpu];
-					 */
-					return 0; /// @bug FIXME
+					return argo::topology::current_numa_node();
 				}
 
 			public:
@@ -112,28 +210,27 @@ namespace argo {
 				 * This lock performs handovers in three levels: First within
 				 * the same NUMA node, then within the same ArgoDSM node, and
 				 * finally over ArgoDSM nodes.
+				 *
+				 * @param adapt_handovers whether to adapt the handover limits
+				 *                        to the measured costs, or to keep
+				 *                        the default limits
 				 */
-				cohort_lock() :
+				explicit cohort_lock(bool adapt_handovers = true) :
 					has_global_lock(false),
-					numanodes(1), // sane default
+					numanodes(argo::topology::numa_nodes()),
 					numahandover(0),
 					nodelockowner(NO_OWNER),
 					global_lock_field(argo::conew_<typename global_lock_type::internal_field_type>()),
 					global_lock(new global_lock_type(global_lock_field)),
-					node_lock(new argo::locallock::ticket_lock())
+					node_lock(new argo::locallock::ticket_lock()),
+					adaptive(adapt_handovers),
+					waiting(0),
+					avg_section_time(-1),
+					avg_handover_time(-1),
+					stats()
 				{
-					int num_cpus = sysconf(_SC_NPROCESSORS_CONF); // sane default
-					numa_mapping.resize(num_cpus, 0);
-					#ifdef ARGO_USE_LIBNUMA
-					/* use libnuma only if it is actually available */
-					if(numa_available() != -1) {
-						numanodes = numa_num_configured_nodes();
-						/* Initialize the NUMA map */
-						for (int i = 0; i < num_cpus; ++i) {
-							numa_mapping[i] = numa_node_of_cpu(i);
-						}
-					}
-					#endif
+					stats.max_handover = MAX_HANDOVER;
+					stats.max_handover_nodelock = MAX_HANDOVER_NODELOCK;
 					/* initialize hierarchy components */
 					handovers = new int[numanodes]();
 					local_lock = new argo::locallock::mcs_lock[numanodes];
@@ -148,13 +245,29 @@ namespace argo {
 					delete[] handovers;
 				}
 
+				/**
+				 * @brief restrict the coherence of lock handovers to a global memory range
+				 * @param addr the start of the protected range
+				 * @param size the size of the protected range in bytes
+				 * @see coherence_scope::add()
+				 */
+				template<typename T>
+				void protect(T* addr, std::size_t size = sizeof(T)) {
+					global_lock->protect(addr, size);
+				}
+
 				/**
 				 * @brief Release the lock
 				 */
 				void unlock() {
+					double section = seconds(section_start, clock::now());
+					stats.critical_section_time += section;
+					ewma(avg_section_time, section);
+
 					/* Check if we can hand over the lock locally */
-					if(local_lock[node].is_contended() && handovers[node] < MAX_HANDOVER){
+					if(local_lock[node].is_contended() && handovers[node] < stats.max_handover){
 						handovers[node]++;
+						stats.numa_handovers++;
 					}
 					else{
 						/* Cant hand over locally in the NUMA node - releases the NUMA lock */
@@ -162,15 +275,23 @@ namespace argo {
 						nodelockowner = NO_OWNER;
 
 						/* check if we should hand over to another NUMA node or ArgoDSM node */
-						if(node_lock->is_contended() && numahandover < MAX_HANDOVER_NODELOCK){
+						if(node_lock->is_contended() && numahandover < stats.max_handover_nodelock){
 							/* Hand over to another NUMA node */
 							numahandover++;
+							stats.node_handovers++;
 						}
 						else{
 							/* hand over to another ArgoDSM node */
 							has_global_lock = false;
 							numahandover = 0;
+							auto start = clock::now();
 							global_lock->unlock();
+							/* still safe to update, the node_lock is held */
+							double handover = seconds(start, clock::now());
+							stats.global_handovers++;
+							stats.global_handover_time += handover;
+							ewma(avg_handover_time, handover);
+							adapt();
 						}
 						node_lock->unlock();
 					}
@@ -181,22 +302,52 @@ namespace argo {
 				 * @brief Acquire the lock
 				 */
 				void lock() {
-					node = numa_node();
+					/*
+					 * Threads of other NUMA nodes may still hold the lock,
+					 * so the node member is only set once the lock is taken.
+					 * This also keeps the lock consistent if the thread
+					 * migrates to another NUMA node while holding it.
+					 */
+					int numa = numa_node();
+					auto start = clock::now();
 
 					/* Take the local lock for your NUMA node */
-					local_lock[node].lock();
+					waiting++;
+					local_lock[numa].lock();
+					std::size_t depth = --waiting;
+					double global_wait = 0;
 					/* Checks if this NUMA node already has the node_lock or not */
-					if(node != nodelockowner){
+					if(numa != nodelockowner){
 						/* Take the node_lock and set that this NUMA node has the node_lock */
 						node_lock->lock();
-						nodelockowner = node;
+						nodelockowner = numa;
 						/* Check if this ArgoDSM node has the global lock or not */
 						if(!has_global_lock){
 							/* Take the global lock */
+							auto global_start = clock::now();
 							global_lock->lock();
 							has_global_lock = true;
+							global_wait = seconds(global_start, clock::now());
 						}
 					}
+					node = numa;
+
+					section_start = clock::now();
+					stats.acquisitions++;
+					stats.wait_time += seconds(start, section_start);
+					stats.global_wait_time += global_wait;
+					stats.queue_depth_sum += depth;
+					stats.max_queue_depth = std::max(stats.max_queue_depth, depth);
+				}
+
+				/**
+				 * @brief get the contention counters of this node
+				 * @return a copy of the counters and the current handover limits
+				 * @note the counters are only consistent while no thread
+				 *       of this node uses the lock
+				 */
+				cohort_lock_statistics statistics() const {
+					return stats;
 				}
 		};
 	} // namespace globallock
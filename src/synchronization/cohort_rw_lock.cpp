@@ -0,0 +1,36 @@
+#include "cohort_rw_lock.hpp"
+
+using rw_lock_t = argo::globallock::cohort_rw_lock;
+
+extern "C" {
+
+	cohortrwlock_t argo_cohortrwlock_create(int writer_preference) {
+		rw_lock_t* newlock = new rw_lock_t(writer_preference != 0);
+		return reinterpret_cast<cohortrwlock_t>(newlock);
+	}
+
+	void argo_cohortrwlock_destroy(cohortrwlock_t lock) {
+		rw_lock_t* l = reinterpret_cast<rw_lock_t*>(lock);
+		delete l;
+	}
+
+	void argo_cohortrwlock_rdlock(cohortrwlock_t lock) {
+		rw_lock_t* l = reinterpret_cast<rw_lock_t*>(lock);
+		l->lock_shared();
+	}
+
+	void argo_cohortrwlock_wrlock(cohortrwlock_t lock) {
+		rw_lock_t* l = reinterpret_cast<rw_lock_t*>(lock);
+		l->lock();
+	}
+
+	void argo_cohortrwlock_rdunlock(cohortrwlock_t lock) {
+		rw_lock_t* l = reinterpret_cast<rw_lock_t*>(lock);
+		l->unlock_shared();
+	}
+
+	void argo_cohortrwlock_wrunlock(cohortrwlock_t lock) {
+		rw_lock_t* l = reinterpret_cast<rw_lock_t*>(lock);
+		l->unlock();
+	}
+}
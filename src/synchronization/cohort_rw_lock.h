@@ -0,0 +1,56 @@
+/**
+ * @file
+ * @brief This file provides a C interface for ArgoDSM-based reader-writer cohort locks
+ */
+
+#ifndef argo_cohort_rw_lock_h
+#define argo_cohort_rw_lock_h argo_cohort_rw_lock_h
+
+/**
+ * @brief reader-writer cohort lock handle dummy type
+ */
+struct cohortrwlock_handle_t {};
+
+/**
+ * @brief type alias for reader-writer cohort locks
+ */
+typedef struct cohortrwlock_handle_t* cohortrwlock_t;
+
+/**
+ * @brief create new reader-writer cohort lock
+ * @param writer_preference non-zero if waiting writers take precedence over new readers
+ * @return handle to new reader-writer cohort lock
+ */
+cohortrwlock_t argo_cohortrwlock_create(int writer_preference);
+
+/**
+ * @brief destroy a reader-writer cohort lock
+ * @param lock the reader-writer cohort lock to destroy
+ */
+void argo_cohortrwlock_destroy(cohortrwlock_t lock);
+
+/**
+ * @brief lock a reader-writer cohort lock for reading
+ * @param lock the reader-writer cohort lock to take
+ */
+void argo_cohortrwlock_rdlock(cohortrwlock_t lock);
+
+/**
+ * @brief lock a reader-writer cohort lock for writing
+ * @param lock the reader-writer cohort lock to take
+ */
+void argo_cohortrwlock_wrlock(cohortrwlock_t lock);
+
+/**
+ * @brief unlock a reader-writer cohort lock taken for reading
+ * @param lock the reader-writer cohort lock to release
+ */
+void argo_cohortrwlock_rdunlock(cohortrwlock_t lock);
+
+/**
+ * @brief unlock a reader-writer cohort lock taken for writing
+ * @param lock the reader-writer cohort lock to release
+ */
+void argo_cohortrwlock_wrunlock(cohortrwlock_t lock);
+
+#endif /* argo_cohort_rw_lock_h */
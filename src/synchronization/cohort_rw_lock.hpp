@@ -0,0 +1,249 @@
+/**
+ * @file
+ * @brief This file provides a reader-writer cohort lock for the ArgoDSM system
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_cohort_rw_lock_hpp
+#define argo_cohort_rw_lock_hpp argo_cohort_rw_lock_hpp
+
+#include "../allocators/collective_allocator.hpp"
+#include "../backend/backend.hpp"
+#include "../data_distribution/global_ptr.hpp"
+#include "coherence_scope.hpp"
+#include "intranode/ticket_lock.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+extern "C" {
+#include "cohort_rw_lock.h"
+}
+
+namespace argo {
+	namespace globallock {
+		/**
+		 * @brief a global reader-writer 'cohort' lock - needs to be called collectively
+		 * @details Readers are counted per ArgoDSM node. The first reader on
+		 *          a node takes a read share of the global lock for the whole
+		 *          node, and the last reader on the node gives it back, so
+		 *          readers on the same node do not contend globally.
+		 *          Writers on a node are serialized locally before they
+		 *          compete for the global lock.
+		 *
+		 *          Taking a read share self-invalidates the node cache as an
+		 *          acquire does, but as readers do not write, giving the share
+		 *          back skips the write-back a release would perform.
+		 *
+		 *          With writer preference, a waiting writer stops other nodes
+		 *          from taking new read shares, and stops readers on its own
+		 *          node from joining the read share of the node.
+		 *
+		 * @warning Do not allocate this lock on the global memory, and keep
+		 *          in mind that the constructor and destructor are collective,
+		 *          as for cohort_lock.
+		 * @warning Readers must not write to the data protected by the lock.
+		 */
+		class cohort_rw_lock {
+			public:
+				/**
+				 * @brief internally used type for lock field
+				 * @note this type may change without warning,
+				 *       user code must use this type alias
+				 */
+				using internal_field_type = std::uint32_t;
+
+			private:
+				/** @brief flag set while a writer holds the lock */
+				static const internal_field_type writer = internal_field_type(1) << 31;
+
+				/** @brief flag set while a writer waits for the readers to leave */
+				static const internal_field_type writer_waiting = internal_field_type(1) << 30;
+
+				/** @brief the bits counting the nodes holding a read share */
+				static const internal_field_type readers = writer_waiting - 1;
+
+				/** @brief longest pause in microseconds between polls of a blocked state */
+				static const int max_backoff = 256;
+
+				/** @brief import global_ptr */
+				using global_field_t = typename argo::data_distribution::global_ptr<internal_field_type>;
+
+				/** @brief whether waiting writers block new readers */
+				const bool prefer_writers;
+
+				/** @brief Field storing the global lock state */
+				internal_field_type* state_field;
+
+				/** @brief pointer to the global lock state */
+				global_field_t state;
+
+				/** @brief protects the node-local reader count */
+				std::mutex reader_mutex;
+
+				/** @brief number of readers holding the lock on this node */
+				std::size_t local_readers;
+
+				/** @brief number of writers on this node waiting for the lock */
+				std::atomic<std::size_t> local_writers_waiting;
+
+				/** @brief lock serializing the writers of this node */
+				argo::locallock::ticket_lock writer_lock;
+
+				/** @brief the global memory made coherent by the lock */
+				coherence_scope scope;
+
+				/**
+				 * @brief atomically update the global lock state
+				 * @param f function computing the new state from the current one,
+				 *          or returning the current one if no update is possible
+				 * @return the state replaced by the update
+				 * @details While the update is blocked, the state is only
+				 *          loaded, with an exponentially growing pause between
+				 *          the loads to limit the traffic to its home node.
+				 */
+				template<typename F>
+				internal_field_type update_state(F f) {
+					int backoff = 1;
+					internal_field_type old = backend::atomic::load(state, atomic::memory_order::relaxed);
+					while(true) {
+						internal_field_type desired = f(old);
+						if(desired == old) {
+							std::this_thread::sleep_for(std::chrono::microseconds(backoff));
+							if(backoff < max_backoff) {
+								backoff *= 2;
+							}
+						} else if(backend::atomic::compare_exchange(
+									state, old, desired, atomic::memory_order::relaxed)) {
+							return old;
+						}
+						old = backend::atomic::load(state, atomic::memory_order::relaxed);
+					}
+				}
+
+				/** @brief take a read share of the global lock for this node */
+				void lock_global_shared() {
+					update_state([this](internal_field_type s) -> internal_field_type {
+						if((s & writer) || (prefer_writers && (s & writer_waiting))) {
+							return s;
+						}
+						return s + 1;
+					});
+					scope.acquire();
+				}
+
+				/** @brief give back the read share of this node */
+				void unlock_global_shared() {
+					/* nothing was written, so no write-back is needed */
+					std::atomic_thread_fence(std::memory_order_release);
+					update_state([](internal_field_type s) -> internal_field_type {
+						return s - 1;
+					});
+				}
+
+			public:
+				/**
+				 * @brief construct global reader-writer 'cohort' lock
+				 * @param writer_preference if true, waiting writers take
+				 *                          precedence over new readers
+				 */
+				explicit cohort_rw_lock(bool writer_preference = true) :
+					prefer_writers(writer_preference),
+					state_field(argo::conew_<internal_field_type>(0)),
+					state(global_field_t(state_field)),
+					local_readers(0),
+					local_writers_waiting(0)
+				{}
+
+				/** @brief a lock can not be copied */
+				cohort_rw_lock(const cohort_rw_lock&) = delete;
+				/** @brief a lock can not be copied */
+				cohort_rw_lock& operator=(const cohort_rw_lock&) = delete;
+
+				/** @brief destroy the lock, collectively */
+				~cohort_rw_lock() {
+					argo::codelete_(state_field);
+				}
+
+				/**
+				 * @brief restrict the coherence of lock handovers to a global memory range
+				 * @param addr the start of the protected range
+				 * @param size the size of the protected range in bytes
+				 * @see coherence_scope::add()
+				 */
+				template<typename T>
+				void protect(T* addr, std::size_t size = sizeof(T)) {
+					scope.add(static_cast<void*>(addr), size);
+				}
+
+				/**
+				 * @brief take the lock for reading
+				 */
+				void lock_shared() {
+					std::unique_lock<std::mutex> guard(reader_mutex);
+					if(prefer_writers) {
+						/* do not extend the read share of the node past a local writer */
+						while(local_writers_waiting.load() > 0) {
+							guard.unlock();
+							std::this_thread::yield();
+							guard.lock();
+						}
+					}
+					if(local_readers == 0) {
+						lock_global_shared();
+					}
+					local_readers++;
+				}
+
+				/**
+				 * @brief release the lock after reading
+				 */
+				void unlock_shared() {
+					std::lock_guard<std::mutex> guard(reader_mutex);
+					local_readers--;
+					if(local_readers == 0) {
+						unlock_global_shared();
+					}
+				}
+
+				/**
+				 * @brief take the lock for writing
+				 */
+				void lock() {
+					local_writers_waiting++;
+					writer_lock.lock();
+					internal_field_type old;
+					do {
+						old = update_state([this](internal_field_type s) -> internal_field_type {
+							if(s & writer) {
+								return s;
+							}
+							if(s & readers) {
+								/* announce the writer, then wait for the readers to leave */
+								return (prefer_writers && !(s & writer_waiting)) ? (s | writer_waiting) : s;
+							}
+							return writer;
+						});
+					} while(old & (writer | readers));
+					local_writers_waiting--;
+					scope.acquire();
+				}
+
+				/**
+				 * @brief release the lock after writing
+				 */
+				void unlock() {
+					scope.release();
+					update_state([](internal_field_type s) -> internal_field_type {
+						return s & ~writer;
+					});
+					writer_lock.unlock();
+				}
+		};
+	} // namespace globallock
+} // namespace argo
+
+#endif /* argo_cohort_rw_lock_hpp */
@@ -0,0 +1,297 @@
+/**
+ * @file
+ * @brief This file provides a queue-based (MCS) lock for the ArgoDSM system
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_global_mcs_lock_hpp
+#define argo_global_mcs_lock_hpp argo_global_mcs_lock_hpp
+
+#include "../backend/backend.hpp"
+#include "../data_distribution/global_ptr.hpp"
+#include "coherence_scope.hpp"
+#include "intranode/ticket_lock.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace argo {
+	namespace globallock {
+		/**
+		 * @brief a global MCS queue lock
+		 * @details ArgoDSM nodes waiting for the lock form a queue. Only the
+		 *          tail of the queue is kept in the global memory. Each node
+		 *          owns a queue node (a successor word and a flag word) in
+		 *          its local lock buffer, spins on its own flag while waiting,
+		 *          and is handed the lock directly by its predecessor. The
+		 *          remote traffic per acquisition is therefore constant,
+		 *          regardless of the number of waiting nodes.
+		 *
+		 *          Threads within one ArgoDSM node are serialized by a
+		 *          node-local lock before the node joins the queue.
+		 *
+		 * @warning As with global_tas_lock, all nodes need to construct the
+		 *          lock with the same field before it is used, followed by a
+		 *          barrier.
+		 */
+		class global_mcs_lock {
+			public:
+				/**
+				 * @brief internally used type for lock field
+				 * @note this type may change without warning,
+				 *       user code must use this type alias
+				 * @note 32 bits are plenty for a queue node id, and 32-bit
+				 *       compare-and-swap is the most widely supported RMA
+				 *       atomic width.
+				 */
+				using internal_field_type = std::uint32_t;
+
+			private:
+				/** @brief constant signifying lock is in an initial state and free */
+				static const internal_field_type init = -2;
+
+				/**
+				 * @brief flag for tail values of a free lock
+				 * @details The remaining bits hold the id of the node that
+				 *          released the lock last.
+				 */
+				static const internal_field_type released = internal_field_type(1) << (std::numeric_limits<internal_field_type>::digits - 1);
+
+				/** @brief constant signifying a queue node has no successor */
+				static const std::size_t no_successor = -1;
+
+				/** @brief constant signifying the lock has not been handed over yet */
+				static const std::size_t waiting = 0;
+
+				/** @brief number of queue nodes available in the lock buffer of each node */
+				static const std::size_t slots = backend::atomic::lockbuffer_words / 2;
+
+				/** @brief number of local polls between synchronized loads of a queue node */
+				static const int sync_interval = 64;
+
+				/** @brief import global_ptr */
+				using global_field_t = typename argo::data_distribution::global_ptr<internal_field_type>;
+
+				/** @brief pointer to the tail of the queue */
+				global_field_t tail;
+
+				/** @brief queue node of this lock in the local lock buffer */
+				std::size_t slot;
+
+				/** @brief lock serializing the threads of this node */
+				argo::locallock::ticket_lock local_lock;
+
+				/** @brief the global memory made coherent on lock handover */
+				coherence_scope scope;
+
+				/**
+				 * @brief protects the lock buffer slot table
+				 * @return the mutex
+				 */
+				static std::mutex& slot_mutex() {
+					static std::mutex m;
+					return m;
+				}
+
+				/**
+				 * @brief usage of the lock buffer slots of this node
+				 * @return one flag per slot, true if the slot is in use
+				 */
+				static std::vector<bool>& slot_table() {
+					static std::vector<bool> table(slots, false);
+					return table;
+				}
+
+				/**
+				 * @brief reserve a queue node in the local lock buffer
+				 * @return the index of the reserved slot
+				 */
+				static std::size_t allocate_slot() {
+					std::lock_guard<std::mutex> guard(slot_mutex());
+					auto& table = slot_table();
+					for(std::size_t i = 0; i < slots; i++) {
+						if(!table[i]) {
+							table[i] = true;
+							return i;
+						}
+					}
+					throw std::runtime_error("ArgoDSM ran out of global MCS lock slots");
+				}
+
+				/**
+				 * @brief return a queue node to the local lock buffer
+				 * @param s the index of the slot to free
+				 */
+				static void free_slot(std::size_t s) {
+					std::lock_guard<std::mutex> guard(slot_mutex());
+					slot_table()[s] = false;
+				}
+
+				/**
+				 * @brief lock buffer word holding the successor of a queue node
+				 * @param s the slot of the queue node
+				 * @return the index of the word in the lock buffer
+				 */
+				static std::size_t successor_word(std::size_t s) {
+					return 2 * s;
+				}
+
+				/**
+				 * @brief lock buffer word holding the handover flag of a queue node
+				 * @param s the slot of the queue node
+				 * @return the index of the word in the lock buffer
+				 */
+				static std::size_t flag_word(std::size_t s) {
+					return 2 * s + 1;
+				}
+
+				/**
+				 * @brief wait until a word of a local queue node changes
+				 * @param word the index of the word in the lock buffer
+				 * @param unchanged the value of the word while waiting
+				 * @return the new value of the word
+				 * @details The word is polled directly in the local lock
+				 *          buffer, and only loaded through the backend once
+				 *          it appears to have changed, or every
+				 *          sync_interval polls should local reads lag behind.
+				 */
+				static std::size_t wait_for_change(std::size_t word, std::size_t unchanged) {
+					const volatile std::size_t* local = backend::atomic::_local_lockbuffer_word(word);
+					std::size_t value;
+					for(int polls = 1; ; polls++) {
+						if(*local != unchanged || polls % sync_interval == 0) {
+							backend::atomic::_load_local_lockbuffer(&value, word);
+							if(value != unchanged) {
+								return value;
+							}
+						}
+						std::this_thread::yield();
+					}
+				}
+
+				/**
+				 * @brief the queue node of this ArgoDSM node
+				 * @return the global id of the queue node
+				 */
+				internal_field_type self() const {
+					return backend::node_id() * slots + slot;
+				}
+
+				/**
+				 * @brief enforce the ordering required after taking the lock
+				 * @param last the node that released the lock last
+				 */
+				void acquired(std::size_t last) {
+					if(last == static_cast<std::size_t>(backend::node_id())) {
+						/* see global_tas_lock::try_lock for why a local fence suffices */
+						std::atomic_thread_fence(std::memory_order_acquire);
+					} else {
+						scope.acquire();
+					}
+				}
+
+			public:
+				/**
+				 * @brief construct global MCS lock from existing memory in global address space
+				 * @param f pointer to global field for storing the queue tail
+				 */
+				global_mcs_lock(internal_field_type* f) : tail(global_field_t(f)), slot(allocate_slot()) {
+					*tail = init;
+				}
+
+				/** @brief a lock can not be copied */
+				global_mcs_lock(const global_mcs_lock&) = delete;
+				/** @brief a lock can not be copied */
+				global_mcs_lock& operator=(const global_mcs_lock&) = delete;
+
+				/** @brief free the local queue node */
+				~global_mcs_lock() {
+					free_slot(slot);
+				}
+
+				/**
+				 * @brief try to lock
+				 * @return true if lock was successfully taken,
+				 *         false otherwise
+				 */
+				bool try_lock() {
+					if(!local_lock.try_lock()) {
+						return false;
+					}
+					const internal_field_type node = backend::node_id();
+					auto old = backend::atomic::load(tail, atomic::memory_order::relaxed);
+					if(old == init || (old & released)) {
+						backend::atomic::_store_lockbuffer(no_successor, node, successor_word(slot));
+						if(backend::atomic::compare_exchange(tail, old, self(), atomic::memory_order::relaxed)) {
+							acquired(old == init ? node : old & ~released);
+							return true;
+						}
+					}
+					local_lock.unlock();
+					return false;
+				}
+
+				/**
+				 * @brief take the lock
+				 */
+				void lock() {
+					local_lock.lock();
+					const internal_field_type node = backend::node_id();
+					backend::atomic::_store_lockbuffer(no_successor, node, successor_word(slot));
+					backend::atomic::_store_lockbuffer(waiting, node, flag_word(slot));
+
+					auto old = backend::atomic::exchange(tail, self(), atomic::memory_order::relaxed);
+					if(old == init) {
+						acquired(node);
+					} else if(old & released) {
+						acquired(old & ~released);
+					} else {
+						/* enqueue behind the predecessor and wait for the handover */
+						backend::atomic::_store_lockbuffer(self(), old / slots, successor_word(old % slots));
+						acquired(wait_for_change(flag_word(slot), waiting) - 1);
+					}
+				}
+
+				/**
+				 * @brief release the lock
+				 */
+				void unlock() {
+					const internal_field_type node = backend::node_id();
+					scope.release();
+
+					std::size_t successor;
+					backend::atomic::_load_local_lockbuffer(&successor, successor_word(slot));
+					if(successor == no_successor) {
+						if(backend::atomic::compare_exchange(tail, self(), released | node,
+								atomic::memory_order::relaxed)) {
+							local_lock.unlock();
+							return;
+						}
+						/* a node is enqueueing, wait until it has linked itself */
+						successor = wait_for_change(successor_word(slot), no_successor);
+					}
+					/* hand over directly, telling the successor who released last */
+					backend::atomic::_store_lockbuffer(node + 1, successor / slots, flag_word(successor % slots));
+					local_lock.unlock();
+				}
+
+				/**
+				 * @brief restrict the coherence of lock handovers to a global memory range
+				 * @param addr the start of the protected range
+				 * @param size the size of the protected range in bytes
+				 * @see coherence_scope::add()
+				 */
+				template<typename T>
+				void protect(T* addr, std::size_t size = sizeof(T)) {
+					scope.add(static_cast<void*>(addr), size);
+				}
+		};
+	} // namespace globallock
+} // namespace argo
+
+#endif /* argo_global_mcs_lock_hpp */
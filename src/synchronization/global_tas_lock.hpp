@@ -9,6 +9,8 @@
 
 #include "../backend/backend.hpp"
 #include "../data_distribution/global_ptr.hpp"
+#include "coherence_scope.hpp"
+#include <atomic>
 #include <chrono>
 #include <thread>
 
@@ -32,6 +34,9 @@ namespace argo {
 				 */
 				global_size_t lastuser;
 
+				/** @brief the global memory made coherent on lock handover */
+				coherence_scope scope;
+
 			public:
 				/**
 				 * @brief construct global tas lock from existing memory in global address space
@@ -78,7 +83,7 @@ namespace argo {
 							 */
 							std::atomic_thread_fence(std::memory_order_acquire);
 						} else {
-							backend::acquire();
+							scope.acquire();
 						}
 						return true;
 					}
@@ -92,10 +97,21 @@ namespace argo {
 				 */
 				void unlock() {
 					std::size_t self = backend::node_id();
-					backend::release();
+					scope.release();
 					backend::atomic::store(lastuser, self);
 				}
 
+				/**
+				 * @brief restrict the coherence of lock handovers to a global memory range
+				 * @param addr the start of the protected range
+				 * @param size the size of the protected range in bytes
+				 * @see coherence_scope::add()
+				 */
+				template<typename T>
+				void protect(T* addr, std::size_t size = sizeof(T)) {
+					scope.add(static_cast<void*>(addr), size);
+				}
+
 				/**
 				 * @brief take the lock
 				 */
@@ -13,12 +13,31 @@
 namespace argo {
 namespace locallock {
 
+mcs_lock::mcs_node* mcs_lock::get_node() {
+	if (free_count > 0) {
+		return free_nodes[--free_count];
+	}
+	if (pool_used < pool_size) {
+		return &pool[pool_used++];
+	}
+	// More locks are held at the same time than the pool can serve
+	return new mcs_node();
+}
+
+void mcs_lock::put_node(mcs_node* node) {
+	if (node >= &pool[0] && node < &pool[pool_size]) {
+		free_nodes[free_count++] = node;
+	} else {
+		delete node;
+	}
+}
+
 void mcs_lock::lock() {
-	mcs_node* self = &selfs[this];
+	mcs_node* self = get_node();
 
 	// See if the lock is locked
 	self->next.store(nullptr, std::memory_order_relaxed);
-	mcs_node* predecessor = _tail.exchange(self, std::memory_order_release);
+	mcs_node* predecessor = _tail.exchange(self, std::memory_order_acq_rel);
 	if (predecessor != nullptr) {
 		// The lock was locked. Put ourselves in the queue...
 		self->locked.store(true, std::memory_order_relaxed);
@@ -27,6 +46,7 @@ void mcs_lock::lock() {
 		while (self->locked.load(std::memory_order_acquire))
 			std::this_thread::yield();
 	}
+	_holder = self;
 }
 
 /**
@@ -37,24 +57,30 @@ void mcs_lock::lock() {
 bool mcs_lock::try_lock() {
 	if (_tail.load(std::memory_order_acquire) != nullptr) {
 		return false;
-	} else {
-		mcs_node* self = &selfs[this];
-		self->next.store(nullptr, std::memory_order_relaxed);
-		return _tail.compare_exchange_strong(self, nullptr);
 	}
+	mcs_node* self = get_node();
+	mcs_node* expected = nullptr; // atomic CAS changes this
+	self->next.store(nullptr, std::memory_order_relaxed);
+	if (_tail.compare_exchange_strong(expected, self, std::memory_order_acq_rel)) {
+		_holder = self;
+		return true;
+	}
+	put_node(self);
+	return false;
 }
 
 /**
  * @brief Release the MCS lock
  */
 void mcs_lock::unlock() {
-	mcs_node* self = &selfs[this];
+	mcs_node* self = _holder;
 	mcs_node* also_self = self; // atomic CAS changes this
 
 	// See if there is anyone waiting
 	if (self->next.load(std::memory_order_acquire) == nullptr) {
 		// Nobody is waiting, unlock the lock and we are done
-		if (_tail.compare_exchange_strong(also_self, nullptr)) {
+		if (_tail.compare_exchange_strong(also_self, nullptr, std::memory_order_acq_rel)) {
+			put_node(self);
 			return;
 		}
 		// Someone is actually waiting, but we don't know who
@@ -62,19 +88,22 @@ void mcs_lock::unlock() {
 			std::this_thread::yield();
 	}
 
-	// Notify whomever is next
-	self->next.load()->locked.store(false, std::memory_order_release);
+	// Notify whomever is next, after which nobody references our node
+	self->next.load(std::memory_order_acquire)->locked.store(false, std::memory_order_release);
+	put_node(self);
 }
 
 /**
  * @brief Check if the lock is contented
  */
 bool mcs_lock::is_contended() {
-	mcs_node *self = &selfs[this];
-	return self->next != nullptr;
+	return _holder->next.load(std::memory_order_acquire) != nullptr;
 }
 
-thread_local std::map<mcs_lock*, mcs_lock::mcs_node> mcs_lock::selfs;
+thread_local mcs_lock::mcs_node mcs_lock::pool[mcs_lock::pool_size];
+thread_local mcs_lock::mcs_node* mcs_lock::free_nodes[mcs_lock::pool_size];
+thread_local std::size_t mcs_lock::free_count = 0;
+thread_local std::size_t mcs_lock::pool_used = 0;
 
 } // namespace locallock
 } // namespace argo
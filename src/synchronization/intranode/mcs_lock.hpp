@@ -9,7 +9,7 @@
 #define MCS_LOCK_HPP_LDFPXGTZ
 
 #include <atomic>
-#include <map>
+#include <cstddef>
 
 namespace argo {
 namespace locallock {
@@ -21,6 +21,12 @@ namespace locallock {
  * https://github.com/kjellwinblad/qd_lock_lib
  * This lock only works for individual nodes and not across multiple nodes.
  *
+ * The queue nodes are taken from a fixed per-thread pool when the lock is
+ * taken and returned to it on release, and the node of the lock holder is
+ * kept in the lock, so no lookup or allocation is needed. Only threads
+ * holding more than pool_size locks at the same time fall back to
+ * allocating queue nodes.
+ *
  * @warning The MCS need to be locked and unlocked by the same thread.
  */
 class mcs_lock {
@@ -28,7 +34,7 @@ private:
 	/** @brief Thread nodes for the lock */
 	struct mcs_node {
 		/** @brief Construct a new node */
-		mcs_node()
+		constexpr mcs_node()
 			: next(nullptr)
 			, locked(false){};
 
@@ -38,18 +44,51 @@ private:
 		std::atomic<bool> locked;
 	};
 
+	/** @brief Number of queue nodes in the pool of each thread */
+	static const std::size_t pool_size = 64;
+
 	/** @brief Last node (thread) to try and acquire the lock */
 	std::atomic<mcs_node*> _tail;
 
-	/** @brief Local nodes for the different locks each thread can have */
-	thread_local static std::map<mcs_lock*, mcs_node> selfs;
+	/** @brief Node of the thread holding the lock, only accessed by the holder */
+	mcs_node* _holder;
+
+	/** @brief Queue nodes of the calling thread */
+	thread_local static mcs_node pool[pool_size];
+
+	/** @brief Queue nodes of the pool returned after use */
+	thread_local static mcs_node* free_nodes[pool_size];
+
+	/** @brief Number of entries in free_nodes */
+	thread_local static std::size_t free_count;
+
+	/** @brief Number of pool nodes that have ever been handed out */
+	thread_local static std::size_t pool_used;
+
+	/**
+	 * @brief Get a queue node for the calling thread
+	 * @return an unused queue node
+	 */
+	static mcs_node* get_node();
+
+	/**
+	 * @brief Give a queue node back after use
+	 * @param node the queue node, which must have been returned by get_node()
+	 */
+	static void put_node(mcs_node* node);
 
 public:
 	/**
 	 * @brief Construct an MCS lock
 	 */
 	mcs_lock()
-		: _tail(nullptr){};
+		: _tail(nullptr)
+		, _holder(nullptr){};
+
+	/** @brief a lock can not be copied */
+	mcs_lock(const mcs_lock&) = delete;
+	/** @brief a lock can not be copied */
+	mcs_lock& operator=(const mcs_lock&) = delete;
 
 	/**
 	 * @brief Acquire the MCS lock.
@@ -8,6 +8,7 @@
 #define argo_local_ticket_lock_hpp argo_local_ticket_lock_hpp
 
 #include <atomic>
+#include <thread>
 
 namespace argo {
 	namespace locallock {
@@ -31,7 +32,20 @@ namespace argo {
 				 */
 				void lock() {
 					int ticket = in_counter.fetch_add(1, std::memory_order_relaxed);
-					while(out_counter.load(std::memory_order_acquire) != ticket);
+					while(out_counter.load(std::memory_order_acquire) != ticket) {
+						/* let the holder run if the threads outnumber the cores */
+						std::this_thread::yield();
+					}
+				}
+
+				/**
+				 * @brief try to take the lock without waiting
+				 * @return true if the lock was taken, false otherwise
+				 */
+				bool try_lock() {
+					int ticket = out_counter.load(std::memory_order_relaxed);
+					return in_counter.compare_exchange_strong(ticket, ticket + 1,
+						std::memory_order_acquire, std::memory_order_relaxed);
 				}
 
 				/**
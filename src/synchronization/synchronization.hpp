@@ -9,7 +9,10 @@
 
 #include <cstddef>
 
+#include "../backend/backend.hpp"
+#include "../types/types.hpp"
 #include "broadcast.hpp"
+#include "team.hpp"
 
 namespace argo {
 	/**
@@ -20,6 +23,41 @@ namespace argo {
 	 * @todo better explanation
 	 */
 	void barrier(std::size_t threadcount=1);
+
+	/**
+	 * @brief a barrier for threads that also combines a value from each thread
+	 * @tparam T the type of the values to combine
+	 * @param value the value of the calling thread
+	 * @param op the operation combining the values
+	 * @param threadcount number of threads on each ArgoDSM node
+	 * @return the values of all threads on all ArgoDSM nodes combined by op
+	 * @details The values of the threads on each node are combined first,
+	 *          then the values of the nodes are combined in the same
+	 *          collective operation that synchronizes them, so this costs
+	 *          no more than barrier().
+	 * @throws std::invalid_argument for a bitwise op on floating point values
+	 */
+	template<typename T>
+	T allreduce(T value, reduction_op op = reduction_op::sum, std::size_t threadcount=1) {
+		return backend::allreduce(value, op, threadcount);
+	}
+
+	/**
+	 * @brief combine a value from each thread on a single ArgoDSM node
+	 * @tparam T the type of the values to combine
+	 * @param value the value of the calling thread
+	 * @param op the operation combining the values
+	 * @param root the ArgoDSM node receiving the result
+	 * @param threadcount number of threads on each ArgoDSM node
+	 * @return on root, the values of all threads on all ArgoDSM nodes
+	 *         combined by op, and an unspecified value on other nodes
+	 * @note Unlike allreduce(), this is not a barrier for the global memory.
+	 * @throws std::invalid_argument for a bitwise op on floating point values
+	 */
+	template<typename T>
+	T reduce(T value, reduction_op op, node_id_t root, std::size_t threadcount=1) {
+		return backend::reduce(value, op, root, threadcount);
+	}
 } // namespace argo
 
 extern "C" {
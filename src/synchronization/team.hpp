@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @brief This file provides teams of nodes synchronizing without the other nodes
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_team_hpp
+#define argo_team_hpp argo_team_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../backend/backend.hpp"
+#include "../types/types.hpp"
+
+namespace argo {
+	/**
+	 * @brief a subset of the ArgoDSM nodes synchronizing among themselves
+	 * @details Barriers, broadcasts and acquires of a team involve its
+	 *          members only, so nodes outside of it are not held up by them.
+	 *          A team barrier or acquire only invalidates the cached data
+	 *          written by members of the team, while the data written by
+	 *          other nodes stays cached until a global synchronization.
+	 *          Members must therefore not rely on a team to see the writes
+	 *          of nodes outside of it.
+	 * @note Creating and destroying a team are collective over its
+	 *       members, and must be done by one thread of each member in the
+	 *       same order. The other nodes do not take part.
+	 */
+	class team {
+		private:
+			/** @brief the members of the team, in increasing order */
+			std::vector<node_id_t> _members;
+
+			/** @brief the backend handle of the team */
+			backend::team_handle _handle;
+
+			/**
+			 * @brief sort the members and check that they form a team of this node
+			 * @param members the members of a team
+			 * @return the members in increasing order
+			 * @throws std::invalid_argument if a member is not a node, or
+			 *         this node is not a member
+			 */
+			static std::vector<node_id_t> check(std::vector<node_id_t> members) {
+				std::sort(members.begin(), members.end());
+				members.erase(std::unique(members.begin(), members.end()), members.end());
+				if(!members.empty() && (members.front() < 0 ||
+						members.back() >= backend::number_of_nodes())) {
+					throw std::invalid_argument("The team members must be nodes");
+				}
+				if(!std::binary_search(members.begin(), members.end(), backend::node_id())) {
+					throw std::invalid_argument("Only members may create a team");
+				}
+				return members;
+			}
+
+		public:
+			/**
+			 * @brief create a team
+			 * @param members the nodes of the team, which must include this node
+			 * @throws std::invalid_argument if a member is not a node, or
+			 *         this node is not a member
+			 */
+			explicit team(std::vector<node_id_t> members)
+				: _members(check(std::move(members))),
+				  _handle(backend::team_create(_members.data(), _members.size())) {}
+
+			/** @brief destroy the team */
+			~team() {
+				backend::team_free(_handle);
+			}
+
+			/** @brief Copy constructor is not allowed */
+			team(const team&) = delete;
+			/** @brief Copy assignment is not allowed */
+			team& operator=(const team&) = delete;
+
+			/**
+			 * @brief get the members of the team
+			 * @return the members in increasing order
+			 */
+			const std::vector<node_id_t>& members() const {
+				return _members;
+			}
+
+			/**
+			 * @brief check whether a node is a member of the team
+			 * @param node the node
+			 * @return true if the node is a member
+			 */
+			bool contains(node_id_t node) const {
+				return std::binary_search(_members.begin(), _members.end(), node);
+			}
+
+			/**
+			 * @brief a barrier for the threads of the members
+			 * @param threadcount number of threads on each member
+			 * @details Like argo::barrier(), but waits for the members only.
+			 *          Afterwards, each member sees the writes the other
+			 *          members made before the barrier.
+			 */
+			void barrier(std::size_t threadcount=1) {
+				backend::team_barrier(_handle, threadcount);
+			}
+
+			/**
+			 * @brief broadcast a single value within the team
+			 * @tparam T the type of the value to broadcast
+			 * @param from the member sending the value
+			 * @param value the value to broadcast, only used on from
+			 * @return the value of from
+			 * @note Collective over the members.
+			 * @throws std::invalid_argument if from is not a member
+			 */
+			template<typename T>
+			T broadcast(node_id_t from, const T value) {
+				static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+				if(!contains(from)) {
+					throw std::invalid_argument("The source of a team broadcast must be a member");
+				}
+				T v = value;
+				backend::_team_broadcast(_handle, from, &v, sizeof(T));
+				return v;
+			}
+
+			/**
+			 * @brief see the writes that members released
+			 * @details Only invalidates the cached data written by members.
+			 */
+			void acquire() {
+				backend::team_acquire(_handle);
+			}
+
+			/**
+			 * @brief make the writes of this node visible to the members
+			 * @note All dirty data of this node is written back, as members
+			 *       may read pages this node does not know they share.
+			 */
+			void release() {
+				backend::team_release(_handle);
+			}
+	};
+} // namespace argo
+
+#endif /* argo_team_hpp */
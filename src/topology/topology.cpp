@@ -0,0 +1,183 @@
+/**
+ * @file
+ * @brief This file implements the detection of the NUMA topology
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+#include <unistd.h>
+
+#ifdef ARGO_USE_LIBNUMA
+#include <numa.h>
+#endif
+
+#include "../env/env.hpp"
+#include "topology.hpp"
+
+namespace {
+	/** @brief sysfs directory describing the NUMA domains */
+	const std::string sysfs_node_dir = "/sys/devices/system/node/node";
+
+	/** @brief flag to ensure the topology is only detected once */
+	std::once_flag detected;
+
+	/** @brief NUMA domain of each configured CPU */
+	std::vector<int> cpu_node;
+
+	/** @brief number of NUMA domains */
+	int node_count = 1;
+
+	/** @brief pinnable CPUs in pack order, grouped by NUMA domain */
+	std::vector<int> packed_cpus;
+
+	/** @brief pinnable CPUs in spread order, round-robin over the NUMA domains */
+	std::vector<int> spread_cpus;
+
+	/**
+	 * @brief parse a sysfs CPU list such as "0-3,8,10-11"
+	 * @param list the CPU list
+	 * @return the CPUs in the list
+	 */
+	std::vector<int> parse_cpulist(const std::string& list) {
+		std::vector<int> cpus;
+		std::stringstream ranges(list);
+		std::string range;
+		while(std::getline(ranges, range, ',')) {
+			if(range.empty() || range == "\n") {
+				continue;
+			}
+			auto dash = range.find('-');
+			int first = std::stoi(range.substr(0, dash));
+			int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+			for(int cpu = first; cpu <= last; cpu++) {
+				cpus.push_back(cpu);
+			}
+		}
+		return cpus;
+	}
+
+	/**
+	 * @brief read the NUMA domains from sysfs
+	 * @return true if at least one NUMA domain was found
+	 */
+	bool detect_sysfs() {
+		bool found = false;
+		/* node ids may be sparse, so probe every id up to the number of CPUs */
+		for(int node = 0; node < static_cast<int>(cpu_node.size()); node++) {
+			std::ifstream file(sysfs_node_dir + std::to_string(node) + "/cpulist");
+			std::string list;
+			if(!file || !std::getline(file, list)) {
+				continue;
+			}
+			found = true;
+			node_count = node + 1;
+			for(int cpu : parse_cpulist(list)) {
+				if(cpu >= 0 && cpu < static_cast<int>(cpu_node.size())) {
+					cpu_node[cpu] = node;
+				}
+			}
+		}
+		return found;
+	}
+
+	/** @brief detect the topology and derive the pinning orders */
+	void detect() {
+		int num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+		if(num_cpus < 1) {
+			num_cpus = 1;
+		}
+		cpu_node.assign(num_cpus, 0);
+		node_count = 1;
+
+		bool found = false;
+		#ifdef ARGO_USE_LIBNUMA
+		/* use libnuma only if it is actually available */
+		if(numa_available() != -1) {
+			node_count = numa_max_node() + 1;
+			for(int cpu = 0; cpu < num_cpus; cpu++) {
+				int node = numa_node_of_cpu(cpu);
+				cpu_node[cpu] = (node < 0) ? 0 : node;
+			}
+			found = true;
+		}
+		#endif
+		if(!found && !detect_sysfs()) {
+			node_count = 1;
+		}
+
+		/* only CPUs this process may run on can be pinned to */
+		cpu_set_t allowed;
+		CPU_ZERO(&allowed);
+		bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+		std::vector<std::vector<int>> domains(node_count);
+		for(int cpu = 0; cpu < num_cpus; cpu++) {
+			if(!have_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) {
+				domains[cpu_node[cpu]].push_back(cpu);
+			}
+		}
+
+		packed_cpus.clear();
+		spread_cpus.clear();
+		for(auto& domain : domains) {
+			packed_cpus.insert(packed_cpus.end(), domain.begin(), domain.end());
+		}
+		for(std::size_t i = 0; spread_cpus.size() < packed_cpus.size(); i++) {
+			for(auto& domain : domains) {
+				if(i < domain.size()) {
+					spread_cpus.push_back(domain[i]);
+				}
+			}
+		}
+		if(packed_cpus.empty()) {
+			packed_cpus.push_back(0);
+			spread_cpus.push_back(0);
+		}
+	}
+} // unnamed namespace
+
+namespace argo {
+	namespace topology {
+		void init() {
+			std::call_once(detected, detect);
+		}
+
+		int numa_nodes() {
+			init();
+			return node_count;
+		}
+
+		int numa_node_of_cpu(int cpu) {
+			init();
+			if(cpu < 0 || cpu >= static_cast<int>(cpu_node.size())) {
+				return 0;
+			}
+			return cpu_node[cpu];
+		}
+
+		int current_numa_node() {
+			return numa_node_of_cpu(sched_getcpu());
+		}
+
+		std::size_t pinnable_cpus() {
+			init();
+			return packed_cpus.size();
+		}
+
+		int cpu_for_thread(std::size_t index, pin_policy policy) {
+			init();
+			const auto& order = (policy == pin_policy::spread) ? spread_cpus : packed_cpus;
+			return order[index % order.size()];
+		}
+
+		int cpu_for_thread(std::size_t index) {
+			auto policy = (env::pin_policy() == 1) ? pin_policy::spread : pin_policy::pack;
+			return cpu_for_thread(index, policy);
+		}
+	} // namespace topology
+} // namespace argo
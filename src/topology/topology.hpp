@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @brief This file provides facilities for querying the NUMA topology of an ArgoDSM node
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#ifndef argo_topology_topology_hpp
+#define argo_topology_topology_hpp argo_topology_topology_hpp
+
+#include <cstddef>
+
+namespace argo {
+	/**
+	 * @brief namespace for the hardware topology of the local ArgoDSM node
+	 * @details The NUMA structure is taken from libnuma if ArgoDSM is built
+	 *          with ARGO_USE_LIBNUMA and libnuma is usable at runtime, else
+	 *          from sysfs. If neither is available, all CPUs are considered
+	 *          to be in a single NUMA domain.
+	 */
+	namespace topology {
+		/** @brief policies for distributing threads over the CPUs */
+		enum class pin_policy {
+			/** @brief fill the CPUs of one NUMA domain before using the next */
+			pack = 0,
+			/** @brief place consecutive threads in different NUMA domains */
+			spread = 1
+		};
+
+		/**
+		 * @brief detect the topology of the local node
+		 * @details Only CPUs the process may run on are considered for
+		 *          pinning, so this should be called before any thread
+		 *          is pinned. It is called by argo::init(), and implicitly
+		 *          by the other functions in this namespace if needed.
+		 */
+		void init();
+
+		/**
+		 * @brief get the number of NUMA domains of the local node
+		 * @return the number of NUMA domains, at least 1
+		 * @note NUMA domain ids are in the range [0, numa_nodes())
+		 */
+		int numa_nodes();
+
+		/**
+		 * @brief get the NUMA domain of a CPU
+		 * @param cpu the CPU to look up
+		 * @return the NUMA domain of the CPU, 0 if it is unknown
+		 */
+		int numa_node_of_cpu(int cpu);
+
+		/**
+		 * @brief get the NUMA domain the calling thread currently runs in
+		 * @return the NUMA domain of the current CPU
+		 */
+		int current_numa_node();
+
+		/**
+		 * @brief get the number of CPUs threads can be pinned to
+		 * @return the number of CPUs in the affinity mask of the process
+		 */
+		std::size_t pinnable_cpus();
+
+		/**
+		 * @brief select the CPU for a node-local thread
+		 * @param index the node-local thread index
+		 * @param policy how to distribute threads over the NUMA domains
+		 * @return the CPU to pin the thread to
+		 * @note indices beyond pinnable_cpus() wrap around
+		 */
+		int cpu_for_thread(std::size_t index, pin_policy policy);
+
+		/**
+		 * @brief select the CPU for a node-local thread
+		 * @param index the node-local thread index
+		 * @return the CPU to pin the thread to
+		 * @see @ref ARGO_PIN_POLICY
+		 */
+		int cpu_for_thread(std::size_t index);
+	} // namespace topology
+} // namespace argo
+
+#endif
@@ -17,6 +17,53 @@ namespace argo {
 	 */
 	using memory_t = char*;
 
+	/**
+	 * @brief operations for combining values in global memory
+	 * @note the bitwise operations are only defined for integer types
+	 */
+	enum class reduction_op {
+		sum, ///< Addition
+		min, ///< Minimum
+		max, ///< Maximum
+		bitwise_and, ///< Bitwise and
+		bitwise_or, ///< Bitwise or
+		bitwise_xor, ///< Bitwise exclusive or
+	};
+
+	/**
+	 * @brief hints on how a region of the global memory is accessed
+	 * @details The hints can be combined with operator|.
+	 * @see argo::advise
+	 */
+	enum class advice : unsigned {
+		normal = 0, ///< No special treatment
+		read_only = 1, ///< Not written by any node while advised
+		node_private = 2, ///< Only accessed by the advising node while advised
+		sequential = 4, ///< Accessed in increasing address order
+		random = 8, ///< Accessed in no particular order
+		write_once = 16, ///< Each page written by at most one node between synchronizations
+	};
+
+	/**
+	 * @brief combine access hints
+	 * @param a the first hints
+	 * @param b the second hints
+	 * @return the hints of both
+	 */
+	constexpr advice operator|(advice a, advice b) {
+		return static_cast<advice>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+	}
+
+	/**
+	 * @brief intersect access hints
+	 * @param a the first hints
+	 * @param b the second hints
+	 * @return the hints common to both
+	 */
+	constexpr advice operator&(advice a, advice b) {
+		return static_cast<advice>(static_cast<unsigned>(a) & static_cast<unsigned>(b));
+	}
+
 } // namespace argo
 
 #endif /* argo_types_types_hpp */
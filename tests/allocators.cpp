@@ -381,6 +381,73 @@ TEST_F(AllocatorTest, PerfectForwardingCollectiveNew) {
 	}
 }
 
+/**
+ * @brief Test that objects constructed in a collective batch are visible after committing
+ */
+TEST_F(AllocatorTest, CollectiveBatchNew) {
+	constexpr std::size_t objects = 64;
+	constexpr std::size_t elements = 1024;
+	std::size_t* values[objects];
+	int* array;
+
+	{
+		argo::collective_batch batch(objects * sizeof(std::size_t) + elements * sizeof(int));
+		for (std::size_t i = 0; i < objects; i++) {
+			values[i] = batch.new_<std::size_t>(i);
+		}
+		array = batch.new_array<int, argo::allocation::initialize>(elements);
+	}
+
+	for (std::size_t i = 0; i < objects; i++) {
+		ASSERT_EQ(i, *values[i]);
+	}
+	for (std::size_t i = 0; i < elements; i++) {
+		ASSERT_EQ(0, array[i]);
+	}
+	for (std::size_t i = 1; i < objects; i++) {
+		ASSERT_NE(values[i-1], values[i]);
+	}
+
+	argo::collective_batch batch;
+	for (std::size_t i = 0; i < objects; i++) {
+		batch.delete_(values[i]);
+	}
+	batch.delete_array(array);
+	ASSERT_NO_THROW(batch.commit());
+}
+
+/**
+ * @brief Test that objects deleted in a collective batch are deinitialized on commit
+ */
+TEST_F(AllocatorTest, CollectiveBatchDelete) {
+	struct counted {
+		int* counter;
+		counted(int* c) : counter(c) {}
+		~counted() {
+			argo::data_distribution::global_ptr<int> c(counter);
+			argo::backend::atomic::fetch_add(c, 1);
+		}
+	};
+	constexpr int objects = 16;
+	int* counter = argo::conew_<int>(0);
+	argo::data_distribution::global_ptr<int> global_counter(counter);
+
+	argo::collective_batch batch;
+	counted* ptrs[objects];
+	for (int i = 0; i < objects; i++) {
+		ptrs[i] = batch.new_<counted>(counter);
+	}
+	batch.commit();
+	ASSERT_EQ(0, argo::backend::atomic::load(global_counter));
+
+	for (int i = 0; i < objects; i++) {
+		batch.delete_(ptrs[i]);
+	}
+	batch.commit();
+	ASSERT_EQ(objects, argo::backend::atomic::load(global_counter));
+	argo::codelete_(counter);
+}
+
 /**
  * @brief Test the "parser" for the allocation parameters
  */
@@ -5,7 +5,9 @@
  */
 
 #include <chrono>
+#include <cstdint>
 #include <random>
+#include <vector>
 
 #include "argo.hpp"
 #include "data_distribution/global_ptr.hpp"
@@ -383,6 +385,174 @@ TEST_F(backendTest, atomicFetchAddPointer) {
 	}
 }
 
+/**
+ * @brief Test the bitwise atomic operations by letting every node set and flip its own bits
+ */
+TEST_F(backendTest, atomicFetchBitwise) {
+	using global_u64 = argo::data_distribution::global_ptr<std::uint64_t>;
+	using global_u8 = argo::data_distribution::global_ptr<std::uint8_t>;
+	global_u64 bits(argo::conew_<std::uint64_t>(0));
+	global_u8 byte(argo::conew_<std::uint8_t>(0xff));
+	const std::uint64_t mine = std::uint64_t(1) << (argo::node_id() % 64);
+
+	std::uint64_t old = argo::backend::atomic::fetch_or(bits, mine);
+	ASSERT_EQ(0u, old & mine);
+	argo::barrier();
+	std::uint64_t all = 0;
+	for (int i = 0; i < argo::number_of_nodes(); ++i) {
+		all |= std::uint64_t(1) << (i % 64);
+	}
+	ASSERT_EQ(all, argo::backend::atomic::load(bits));
+	argo::barrier();
+
+	argo::backend::atomic::fetch_xor(bits, mine);
+	argo::backend::atomic::fetch_and(byte, std::uint8_t(~(1u << (argo::node_id() % 8))));
+	argo::barrier();
+	ASSERT_EQ(0u, argo::backend::atomic::load(bits));
+	std::uint8_t cleared = 0xff;
+	for (int i = 0; i < argo::number_of_nodes(); ++i) {
+		cleared &= ~(1u << (i % 8));
+	}
+	ASSERT_EQ(cleared, argo::backend::atomic::load(byte));
+}
+
+/**
+ * @brief Test the minimum and maximum atomic operations from all nodes
+ */
+TEST_F(backendTest, atomicFetchMinMax) {
+	global_int imin(argo::conew_<int>(i_const));
+	global_int imax(argo::conew_<int>(i_const));
+	global_double dmin(argo::conew_<double>(d_const));
+	global_double dmax(argo::conew_<double>(d_const));
+	global_uint umax(argo::conew_<unsigned>(0));
+
+	for (int i = 0; i < 100; ++i) {
+		argo::backend::atomic::fetch_min(imin, i_const - i - argo::node_id());
+		argo::backend::atomic::fetch_max(imax, i_const + i + argo::node_id());
+		argo::backend::atomic::fetch_min(dmin, d_const - i);
+		argo::backend::atomic::fetch_max(dmax, d_const + i);
+		argo::backend::atomic::fetch_max(umax, j_const - i);
+	}
+	/* a min that does not change the value returns it unchanged */
+	ASSERT_GE(d_const - 99, argo::backend::atomic::fetch_min(dmin, d_const));
+
+	argo::barrier();
+	const int last = argo::number_of_nodes() - 1;
+	ASSERT_EQ(i_const - 99 - last, *imin);
+	ASSERT_EQ(i_const + 99 + last, *imax);
+	ASSERT_EQ(d_const - 99, *dmin);
+	ASSERT_EQ(d_const + 99, *dmax);
+	ASSERT_EQ(j_const, *umax);
+}
+
+/**
+ * @brief Test that non-blocking atomic operations complete on flush and barrier
+ */
+TEST_F(backendTest, atomicPostedOps) {
+	constexpr int bins = 8;
+	constexpr int rounds = 10000;
+	long* counters = argo::conew_array<long>(bins);
+	global_uint bits(argo::conew_<unsigned>(0));
+	global_double sum(argo::conew_<double>(0.0));
+	if (argo::node_id() == 0) {
+		for (int i = 0; i < bins; ++i) {
+			counters[i] = 0;
+		}
+	}
+	argo::barrier();
+
+	/* enough operations to also trigger the internal flushes */
+	for (int i = 0; i < rounds; ++i) {
+		argo::backend::atomic::add(argo::data_distribution::global_ptr<long>(&counters[i % bins]), 1);
+	}
+	argo::backend::atomic::bor(bits, 1u << argo::node_id());
+	argo::backend::atomic::add(sum, 0.5);
+	argo::backend::atomic::flush();
+	/* flushed operations are visible to the atomic operations of this node */
+	ASSERT_LE(0.5, argo::backend::atomic::load(sum));
+	ASSERT_NE(0u, argo::backend::atomic::load(bits) & (1u << argo::node_id()));
+
+	argo::barrier();
+	const int nodes = argo::number_of_nodes();
+	for (int i = 0; i < bins; ++i) {
+		ASSERT_EQ(static_cast<long>(nodes) * rounds / bins, counters[i]);
+	}
+	ASSERT_EQ((1u << nodes) - 1, *bits);
+	ASSERT_EQ(0.5 * nodes, *sum);
+	argo::barrier();
+
+	/* a barrier alone completes the operations as well */
+	argo::backend::atomic::bxor(bits, 1u << argo::node_id());
+	argo::backend::atomic::band(bits, ~0u);
+	argo::barrier();
+	ASSERT_EQ(0u, *bits);
+}
+
+/**
+ * @brief Test batched fetch&add by building a histogram from all nodes
+ */
+TEST_F(backendTest, atomicFetchAddManyHistogram) {
+	constexpr int bins = 16;
+	constexpr int batch = 64;
+	constexpr int rounds = 100;
+	int* histogram = argo::conew_array<int>(bins);
+	if (argo::node_id() == 0) {
+		for (int i = 0; i < bins; ++i) {
+			histogram[i] = 0;
+		}
+	}
+	argo::barrier();
+
+	std::vector<global_int> objs;
+	std::vector<int> values(batch, 1);
+	for (int i = 0; i < batch; ++i) {
+		objs.emplace_back(&histogram[i % bins]);
+	}
+	for (int r = 0; r < rounds; ++r) {
+		argo::backend::atomic::fetch_add_many(objs.data(), values.data(), batch);
+	}
+
+	argo::barrier();
+	for (int i = 0; i < bins; ++i) {
+		ASSERT_EQ(rounds * (batch / bins) * argo::number_of_nodes(), histogram[i]);
+	}
+	argo::codelete_array(histogram);
+}
+
+/**
+ * @brief Test that batched fetch&add returns the old values
+ */
+TEST_F(backendTest, atomicFetchAddManyOldValues) {
+	const int nodes = argo::number_of_nodes();
+	double* d = argo::conew_array<double>(nodes);
+	unsigned* u = argo::conew_array<unsigned>(nodes);
+	d[argo::node_id()] = 0;
+	u[argo::node_id()] = 0;
+	argo::barrier();
+
+	/* only this node updates its own elements, so the old values are known */
+	global_double d_objs[2] = {global_double(&d[argo::node_id()]), global_double(&d[argo::node_id()])};
+	global_uint u_objs[2] = {global_uint(&u[argo::node_id()]), global_uint(&u[argo::node_id()])};
+	double d_values[2] = {d_const, d_const};
+	unsigned u_values[2] = {j_const, 1};
+	double d_old[2];
+	unsigned u_old[2];
+	argo::backend::atomic::fetch_add_many(d_objs, d_values, 2, d_old);
+	argo::backend::atomic::fetch_add_many(u_objs, u_values, 2, u_old);
+	ASSERT_EQ(0.0, d_old[0]);
+	ASSERT_EQ(d_const, d_old[1]);
+	ASSERT_EQ(0u, u_old[0]);
+	ASSERT_EQ(j_const, u_old[1]);
+
+	argo::barrier();
+	for (int i = 0; i < nodes; ++i) {
+		ASSERT_EQ(2 * d_const, d[i]);
+		ASSERT_EQ(j_const + 1, u[i]);
+	}
+	argo::codelete_array(u);
+	argo::codelete_array(d);
+}
+
 /**
  * @brief Test selective coherence on a spinflag
  */
@@ -520,6 +690,126 @@ TEST_F(backendTest, selectiveUnaligned) {
 	argo::codelete_array(array);
 }
 
+/**
+ * @brief Test selective coherence on several scattered ranges at once
+ */
+TEST_F(backendTest, selectiveMultiRange) {
+	const std::size_t array_size = 65536;
+	const std::size_t row_size = 1024;
+	const std::size_t row_count = array_size/row_size;
+	int* a = argo::conew_array<int>(array_size);
+	int* b = argo::conew_array<int>(array_size);
+	unsigned int* flag(argo::conew_<unsigned>(0));
+	std::chrono::system_clock::time_point max_time =
+		std::chrono::system_clock::now() + deadlock_threshold;
+
+	// Initialize
+	if(argo::node_id() == 0){
+		for(std::size_t i=0; i<array_size; i++){
+			a[i] = 0;
+			b[i] = 0;
+		}
+	}
+	argo::barrier();
+
+	// The first element of every row of both arrays, and an empty range
+	std::vector<argo::backend::memory_range> rows;
+	for(std::size_t r=0; r<row_count; r++){
+		rows.push_back({&a[r*row_size], sizeof(int)});
+		rows.push_back({&b[r*row_size], sizeof(int)});
+	}
+	rows.push_back({a, 0});
+
+	// Set the rows on node 0, then set flag
+	if(argo::node_id() == 0){
+		for(std::size_t r=0; r<row_count; r++){
+			a[r*row_size] = i_const;
+			b[r*row_size] = 2*i_const;
+		}
+		argo::backend::selective_release(rows);
+		*flag = 1;
+		argo::backend::selective_release({{flag, sizeof(unsigned)}});
+	}
+	// Read the rows on every other node to make sure they are cached
+	else{
+		int tmp = 0;
+		for(std::size_t r=0; r<row_count; r++){
+			tmp += a[r*row_size] + b[r*row_size];
+		}
+		ASSERT_LE(tmp, 3*i_const*static_cast<int>(row_count));
+	}
+
+	// Wait for the flag change to be visible on every node
+	while(*flag != 1){
+		ASSERT_LT(std::chrono::system_clock::now(), max_time);
+		argo::backend::selective_acquire({{flag, sizeof(unsigned)}});
+	}
+
+	// Check the rows on every node
+	argo::backend::selective_acquire(rows);
+	for(std::size_t r=0; r<row_count; r++){
+		ASSERT_EQ(i_const, a[r*row_size]);
+		ASSERT_EQ(2*i_const, b[r*row_size]);
+	}
+
+	// Clean up
+	argo::codelete_(flag);
+	argo::codelete_array(b);
+	argo::codelete_array(a);
+}
+
+/**
+ * @brief Test that asynchronous releases publish the writes
+ */
+TEST_F(backendTest, releaseAsync) {
+	const std::size_t array_size = 65536;
+	long* array = argo::conew_array<long>(array_size);
+	int* flag(argo::conew_<int>(0));
+	std::chrono::system_clock::time_point max_time =
+		std::chrono::system_clock::now() + deadlock_threshold;
+	argo::barrier();
+
+	// Publish the ticket of the release through a relaxed flag
+	if(argo::node_id() == 0){
+		for(std::size_t i=0; i<array_size; i++){
+			array[i] = i;
+		}
+		argo::ticket t = argo::release_async();
+		argo::wait(t);
+		ASSERT_TRUE(argo::test(t));
+		argo::backend::atomic::store(global_int(flag), 1,
+				argo::atomic::memory_order::relaxed);
+	}
+	else{
+		while(argo::backend::atomic::load(global_int(flag),
+					argo::atomic::memory_order::relaxed) != 1){
+			ASSERT_LT(std::chrono::system_clock::now(), max_time);
+		}
+		argo::backend::acquire();
+		for(std::size_t i=0; i<array_size; i++){
+			ASSERT_EQ(static_cast<long>(i), array[i]);
+		}
+	}
+	argo::barrier();
+
+	// Releases complete at the latest in the next barrier
+	if(argo::node_id() == argo::number_of_nodes()-1){
+		for(std::size_t i=0; i<array_size; i++){
+			array[i] = -static_cast<long>(i);
+		}
+	}
+	argo::ticket t = argo_release_async();
+	argo::barrier();
+	ASSERT_TRUE(argo::test(t));
+	for(std::size_t i=0; i<array_size; i++){
+		ASSERT_EQ(-static_cast<long>(i), array[i]);
+	}
+
+	// Clean up
+	argo::codelete_(flag);
+	argo::codelete_array(array);
+}
+
 /**
  * @brief Test write buffer under load with random access patterns
  */
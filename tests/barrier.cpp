@@ -42,6 +42,85 @@ TEST_F(barrierTest, simpleBarrier) {
 	ASSERT_NO_THROW(argo::barrier());
 }
 
+/**
+ * @brief Unittest that checks that allreduce synchronizes the memory as a barrier
+ */
+TEST_F(barrierTest, allreduceBarrier) {
+	int* global = argo::conew_array<int>(argo::number_of_nodes());
+	for(int round = 1; round <= 10; round++) {
+		global[argo::node_id()] = round * argo::node_id();
+		int sum = argo::allreduce(global[argo::node_id()]);
+		int seen = 0;
+		for(int n = 0; n < argo::number_of_nodes(); n++) {
+			seen += global[n];
+		}
+		ASSERT_EQ(sum, seen);
+		argo::barrier();
+	}
+	ASSERT_THROW(argo::allreduce(1.0, argo::reduction_op::bitwise_and), std::invalid_argument);
+	argo::codelete_array(global);
+}
+
+/**
+ * @brief Unittest that checks that reduce delivers the result to the root node
+ */
+TEST_F(barrierTest, reduceToRoot) {
+	const int nodes = argo::number_of_nodes();
+	for(int root = 0; root < nodes; root++) {
+		long sum = argo::reduce(static_cast<long>(argo::node_id() + 1), argo::reduction_op::sum, root);
+		if(argo::node_id() == root) {
+			ASSERT_EQ(static_cast<long>(nodes) * (nodes + 1) / 2, sum);
+		}
+	}
+}
+
+/**
+ * @brief Unittest that checks that teams synchronize their members only
+ */
+TEST_F(barrierTest, teamBarrier) {
+	const int nodes = argo::number_of_nodes();
+	const int me = argo::node_id();
+	int* global = argo::conew_array<int>(nodes);
+	ASSERT_THROW(argo::team({me, nodes}), std::invalid_argument);
+	if(me != 0) {
+		ASSERT_THROW(argo::team({0}), std::invalid_argument);
+	}
+	if(me % 2 == 0) {
+		std::vector<argo::node_id_t> even;
+		for(int n = 0; n < nodes; n += 2) {
+			even.push_back(n);
+		}
+		argo::team t(even);
+		ASSERT_TRUE(t.contains(me));
+		ASSERT_FALSE(t.contains(1));
+		for(int round = 1; round <= 5; round++) {
+			global[me] = round * (me + 1);
+			t.barrier();
+			for(auto n : t.members()) {
+				ASSERT_EQ(round * (n + 1), global[n]);
+			}
+			t.barrier();
+		}
+		const int last = t.members().back();
+		ASSERT_EQ(last + 1, t.broadcast(last, me + 1));
+		ASSERT_THROW(t.broadcast(1, me), std::invalid_argument);
+
+		global[me] = -me;
+		t.release();
+		t.barrier();
+		t.acquire();
+		for(auto n : t.members()) {
+			ASSERT_EQ(-n, global[n]);
+		}
+	}
+	argo::barrier();
+	for(int n = 0; n < nodes; n += 2) {
+		ASSERT_EQ(-n, global[n]);
+	}
+	argo::barrier();
+	argo::codelete_array(global);
+}
+
 /**
  * @brief Unittest that checks that the barrier call works with multiple threads
  */
@@ -79,6 +158,29 @@ TEST_P(barrierTest, threadBarrier) {
 	}
 }
 
+/**
+ * @brief Unittest that checks that allreduce combines the values of all threads on all nodes
+ */
+TEST_P(barrierTest, threadAllreduce) {
+	std::vector<std::thread> thread_array;
+	const int threads = GetParam();
+	const long nodes = argo::number_of_nodes();
+	for(int t = 0; t < threads; t++) {
+		thread_array.push_back(std::thread([=]{
+			const long id = argo::node_id() * threads + t;
+			const long all = nodes * threads;
+			ASSERT_EQ(all * (all - 1) / 2, argo::allreduce(id, argo::reduction_op::sum, threads));
+			ASSERT_EQ(all - 1, argo::allreduce(id, argo::reduction_op::max, threads));
+			ASSERT_EQ(0.0, argo::allreduce(static_cast<double>(id), argo::reduction_op::min, threads));
+			unsigned bits = argo::allreduce(1u << argo::node_id(), argo::reduction_op::bitwise_or, threads);
+			ASSERT_EQ((1u << nodes) - 1, bits);
+		}));
+	}
+	for(auto& t : thread_array) {
+		t.join();
+	}
+}
+
 /** @brief Test from 0 threads to max_threads, both inclusive */
 INSTANTIATE_TEST_CASE_P(threadCount, barrierTest, ::testing::Range(0, max_threads+1));
 
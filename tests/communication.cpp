@@ -0,0 +1,493 @@
+/**
+ * @file
+ * @brief This file provides tests for the communication facilities of ArgoDSM
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "argo.hpp"
+#include "data_distribution/global_ptr.hpp"
+#include "gtest/gtest.h"
+
+/** @brief ArgoDSM memory size */
+constexpr std::size_t size = 1<<26;
+/** @brief ArgoDSM cache size */
+constexpr std::size_t cache_size = size/2;
+
+/**
+ * @brief Class for the gtests fixture tests. Will reset the allocators to a clean state for every test
+ */
+class communicationTest : public testing::Test {
+	protected:
+		communicationTest() {
+			argo_reset();
+			argo::barrier();
+		}
+
+		~communicationTest() {
+			argo::barrier();
+		}
+};
+
+/**
+ * @brief Unittest that checks that all nodes can accumulate into a range spanning all home nodes
+ */
+TEST_F(communicationTest, AccumulateSum) {
+	/* large enough to be distributed over all nodes */
+	const std::size_t n = size / sizeof(long) / 4 * 3;
+	long* array = argo::conew_array<long>(n);
+	if(argo::node_id() == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			array[i] = i;
+		}
+	}
+	argo::barrier();
+
+	std::vector<long> values(n);
+	for(std::size_t i = 0; i < n; i++) {
+		values[i] = argo::node_id() + 1;
+	}
+	argo::accumulate(array, values.data(), n);
+	/* an unaligned part of the range, twice */
+	argo::accumulate(array + 3, values.data(), 1000);
+	argo::accumulate(argo::data_distribution::global_ptr<long>(array + 3), values.data(), 1000);
+	argo::barrier();
+
+	const long nodes = argo::number_of_nodes();
+	const long total = nodes * (nodes + 1) / 2;
+	for(std::size_t i = 0; i < n; i++) {
+		const long expected = i + ((i >= 3 && i < 1003) ? 3 : 1) * total;
+		ASSERT_EQ(expected, array[i]);
+	}
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief Unittest that checks accumulating with other operations and types
+ */
+TEST_F(communicationTest, AccumulateOps) {
+	const std::size_t n = 10000;
+	unsigned* bits = argo::conew_array<unsigned>(n);
+	double* maxima = argo::conew_array<double>(n);
+	if(argo::node_id() == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			bits[i] = 0;
+			maxima[i] = 0.0;
+		}
+	}
+	argo::barrier();
+
+	std::vector<unsigned> bit(n, 1u << argo::node_id());
+	std::vector<double> value(n);
+	for(std::size_t i = 0; i < n; i++) {
+		value[i] = i * (argo::node_id() + 1);
+	}
+	argo::accumulate(bits, bit.data(), n, argo::reduction_op::bitwise_or);
+	argo::accumulate(maxima, value.data(), n, argo::reduction_op::max);
+	argo::accumulate<long>(nullptr, nullptr, 0);
+	ASSERT_THROW(argo::accumulate(maxima, value.data(), n, argo::reduction_op::bitwise_xor),
+			std::invalid_argument);
+	argo::barrier();
+
+	const int nodes = argo::number_of_nodes();
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ((1u << nodes) - 1, bits[i]);
+		ASSERT_EQ(static_cast<double>(i * nodes), maxima[i]);
+	}
+	argo::codelete_array(bits);
+	argo::codelete_array(maxima);
+}
+
+/**
+ * @brief Unittest that checks that all nodes can put to and get from a range spanning all home nodes
+ */
+TEST_F(communicationTest, GetPut) {
+	const std::size_t n = size / sizeof(int) / 4 * 3;
+	int* array = argo::conew_array<int>(n);
+	const std::size_t nodes = argo::number_of_nodes();
+	const std::size_t id = argo::node_id();
+
+	/* every node writes an unaligned slice of the array */
+	const std::size_t begin = n * id / nodes;
+	const std::size_t end = n * (id + 1) / nodes;
+	std::vector<int> local(n);
+	for(std::size_t i = begin; i < end; i++) {
+		local[i] = i * 3 + 1;
+	}
+	argo::put(array + begin, local.data() + begin, end - begin);
+	argo::barrier();
+
+	std::vector<int> result(n, 0);
+	argo::get(result.data(), argo::data_distribution::global_ptr<int>(array), n);
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ(static_cast<int>(i * 3 + 1), result[i]);
+		ASSERT_EQ(static_cast<int>(i * 3 + 1), array[i]);
+	}
+	ASSERT_THROW(argo::get(array, array + 1, 1), std::invalid_argument);
+	ASSERT_THROW(argo::put(array, array + 1, 1), std::invalid_argument);
+	/* the global side must lie inside the global memory */
+	int* const global_end = reinterpret_cast<int*>(
+		argo::backend::global_base() + argo::backend::global_size());
+	ASSERT_THROW(argo::get(result.data(), global_end - 1, 2), std::invalid_argument);
+	ASSERT_THROW(argo::put(global_end - 1, local.data(), 2), std::invalid_argument);
+	ASSERT_THROW(argo::get(result.data(), local.data(), 1), std::invalid_argument);
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief Unittest that checks that get and put are coherent with cached copies
+ */
+TEST_F(communicationTest, GetPutCached) {
+	const std::size_t n = size / sizeof(int) / 4 * 3;
+	int* array = argo::conew_array<int>(n);
+	const std::size_t nodes = argo::number_of_nodes();
+	const std::size_t id = argo::node_id();
+	/* a range of the array homed on another node */
+	const std::size_t begin = n * ((id + 1) % nodes) / nodes;
+	if(id == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			array[i] = 0;
+		}
+	}
+	argo::barrier();
+
+	const std::size_t count = 4096;
+	std::vector<int> local(count);
+	if(id == 0) {
+		/* own writes are seen through the cache */
+		for(std::size_t i = 0; i < count; i++) {
+			array[begin + i] = i + 1;
+		}
+		argo::get(local.data(), array + begin, count);
+		for(std::size_t i = 0; i < count; i++) {
+			ASSERT_EQ(static_cast<int>(i + 1), local[i]);
+		}
+		/* cached copies are replaced by put data */
+		for(std::size_t i = 0; i < count; i++) {
+			local[i] = -static_cast<int>(i);
+		}
+		argo::put(array + begin + 1, local.data() + 1, count - 2);
+		for(std::size_t i = 1; i < count - 1; i++) {
+			ASSERT_EQ(-static_cast<int>(i), array[begin + i]);
+		}
+		ASSERT_EQ(1, array[begin]);
+		ASSERT_EQ(static_cast<int>(count), array[begin + count - 1]);
+	}
+	argo::barrier();
+
+	std::vector<int> expected(count);
+	for(std::size_t i = 0; i < count; i++) {
+		expected[i] = (i == 0 || i == count - 1) ? i + 1 : -static_cast<int>(i);
+	}
+	const std::size_t other = n * (1 % nodes) / nodes;
+	argo::get(local.data(), array + other, count);
+	for(std::size_t i = 0; i < count; i++) {
+		ASSERT_EQ(expected[i], local[i]);
+		ASSERT_EQ(expected[i], array[other + i]);
+	}
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief Unittest that checks the non-blocking variants of get and put
+ */
+TEST_F(communicationTest, GetPutAsync) {
+	const std::size_t n = 100000;
+	long* array = argo::conew_array<long>(n * argo::number_of_nodes());
+	long* mine = array + n * argo::node_id();
+
+	std::vector<long> local(n);
+	for(std::size_t i = 0; i < n; i++) {
+		local[i] = i + argo::node_id();
+	}
+	argo::ticket first = argo::put_async(mine, local.data(), n / 2);
+	argo::ticket second = argo::put_async(mine + n / 2, local.data() + n / 2, n - n / 2);
+	argo::wait(second);
+	ASSERT_TRUE(argo::test(first));
+	argo::barrier();
+
+	const std::size_t next = (argo::node_id() + 1) % argo::number_of_nodes();
+	std::vector<long> result(n, -1);
+	argo::wait(argo::get_async(result.data(), array + n * next, n));
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ(static_cast<long>(i + next), result[i]);
+	}
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief Unittest that checks gathering and scattering columns of a 2D array
+ */
+TEST_F(communicationTest, GatherScatterStrided) {
+	/* large enough for the columns to span all home nodes */
+	const std::size_t rows = 4096;
+	const std::size_t cols = size / sizeof(double) / rows / 2;
+	double* matrix = argo::conew_array<double>(rows * cols);
+	const std::size_t nodes = argo::number_of_nodes();
+	const std::size_t id = argo::node_id();
+
+	/* every node writes its own sample of columns */
+	const std::size_t step = 7;
+	std::vector<double> column(rows);
+	for(std::size_t c = id * step; c < cols; c += nodes * step) {
+		for(std::size_t r = 0; r < rows; r++) {
+			column[r] = r * cols + c;
+		}
+		argo::scatter(matrix + c, column.data(), rows, cols);
+	}
+	argo::barrier();
+
+	for(std::size_t c = 0; c < cols; c += step) {
+		argo::gather(column.data(), matrix + c, rows, cols);
+		for(std::size_t r = 0; r < rows; r++) {
+			ASSERT_EQ(static_cast<double>(r * cols + c), column[r]);
+		}
+	}
+	/* a row backwards */
+	std::vector<double> row(cols);
+	argo::gather(row.data(), matrix + 5 * cols + cols - 1, cols, -1);
+	for(std::size_t c = 0; c < cols; c++) {
+		if((cols - 1 - c) % step == 0) {
+			ASSERT_EQ(static_cast<double>(5 * cols + cols - 1 - c), row[c]);
+		}
+	}
+	ASSERT_EQ(static_cast<double>(cols + 7), matrix[cols + 7]);
+	ASSERT_THROW(argo::gather(matrix, matrix + 1, 2, 1), std::invalid_argument);
+	argo::codelete_array(matrix);
+}
+
+/**
+ * @brief Unittest that checks gathering and scattering through index lists
+ */
+TEST_F(communicationTest, GatherScatterIndexed) {
+	const std::size_t n = size / sizeof(int) / 2;
+	int* array = argo::conew_array<int>(n);
+	const std::size_t nodes = argo::number_of_nodes();
+	const std::size_t id = argo::node_id();
+	if(id == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			array[i] = -1;
+		}
+	}
+	argo::barrier();
+
+	/* every node scatters to a distinct set of scattered indices */
+	const std::size_t count = 10000;
+	std::vector<unsigned> indices(count);
+	std::vector<int> values(count);
+	for(std::size_t i = 0; i < count; i++) {
+		indices[i] = ((i * 7919) % count * nodes + id) * (n / count / nodes);
+		values[i] = indices[i];
+	}
+	/* the own writes in the cache are replaced */
+	array[indices[0]] = 42;
+	argo::scatter(array, values.data(), indices.data(), count);
+	ASSERT_EQ(static_cast<int>(indices[0]), array[indices[0]]);
+	argo::barrier();
+
+	const std::size_t other = (id + 1) % nodes;
+	for(std::size_t i = 0; i < count; i++) {
+		indices[i] = (i * nodes + other) * (n / count / nodes);
+	}
+	argo::gather(values.data(), array, indices.data(), count);
+	for(std::size_t i = 0; i < count; i++) {
+		ASSERT_EQ(static_cast<int>(indices[i]), values[i]);
+	}
+	ASSERT_EQ(-1, array[1]);
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief Unittest that checks collective fill and memset against cached and dirty copies
+ */
+TEST_F(communicationTest, FillMemset) {
+	const std::size_t n = size / sizeof(long) / 4 * 3;
+	long* array = argo::conew_array<long>(n);
+	const std::size_t nodes = argo::number_of_nodes();
+	const std::size_t id = argo::node_id();
+
+	argo::fill(array, n, 7L);
+	for(std::size_t i = id; i < n; i += 997) {
+		ASSERT_EQ(7, array[i]);
+	}
+	/* dirty writes before the fill must not survive it */
+	array[n / nodes * id + 1] = 3;
+	argo::fill(array + 1, n - 2, -2L);
+	ASSERT_EQ(7, array[0]);
+	ASSERT_EQ(7, array[n - 1]);
+	for(std::size_t i = 1; i < n - 1; i++) {
+		ASSERT_EQ(-2, array[i]);
+	}
+
+	/* a byte pattern over an unaligned range */
+	char* bytes = reinterpret_cast<char*>(array) + 5;
+	argo::memset(bytes, 0x5a, 3 * 4096 * nodes);
+	for(std::size_t i = 0; i < 3 * 4096 * nodes; i += 31) {
+		ASSERT_EQ(0x5a, bytes[i]);
+	}
+	ASSERT_EQ(7, reinterpret_cast<char*>(array)[0]);
+	ASSERT_EQ(-1, bytes[3 * 4096 * nodes]);
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief Unittest that checks collective copies between global arrays
+ */
+TEST_F(communicationTest, CopyGlobal) {
+	const std::size_t n = size / sizeof(int) / 4;
+	int* src = argo::conew_array<int>(n);
+	int* dst = argo::conew_array<int>(n + 1);
+	if(argo::node_id() == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			src[i] = i;
+		}
+	}
+	argo::barrier();
+
+	/* misaligned against the source, so parts span two source pages */
+	argo::copy(dst + 1, src, n);
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ(static_cast<int>(i), dst[i + 1]);
+	}
+	ASSERT_THROW(argo::copy(src + 1, src, 2), std::invalid_argument);
+	argo::codelete_array(dst);
+	argo::codelete_array(src);
+}
+
+/**
+ * @brief Unittest that checks that broadcast ranges are cached coherently on all nodes
+ */
+TEST_F(communicationTest, BroadcastRange) {
+	const std::size_t n = size / sizeof(int) / 8;
+	const argo::node_id_t nodes = argo::number_of_nodes();
+	const argo::node_id_t root = nodes - 1;
+	int* array = argo::conew_array<int>(n);
+	if(argo::node_id() == root) {
+		for(std::size_t i = 0; i < n; i++) {
+			array[i] = i;
+		}
+	}
+
+	/* unaligned, and larger than one broadcast */
+	argo::broadcast_range(array + 3, (n - 5) * sizeof(int), root);
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ(static_cast<int>(i), array[i]);
+	}
+	argo::barrier();
+
+	/* the nodes caching the range see later writes */
+	for(int round = 0; round < 2; round++) {
+		for(std::size_t i = argo::node_id(); i < n; i += 1001) {
+			array[i] = -static_cast<int>(i) - round;
+		}
+		argo::barrier();
+		for(std::size_t i = 0; i < n; i++) {
+			const int expected = (i % 1001 < static_cast<std::size_t>(nodes)) ?
+				-static_cast<int>(i) - round : static_cast<int>(i);
+			ASSERT_EQ(expected, array[i]);
+		}
+		argo::broadcast_range(array, n * sizeof(int), round % nodes);
+	}
+	ASSERT_THROW(argo::broadcast_range(array, n * sizeof(int), nodes), std::invalid_argument);
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief adds to a counter at its home node
+ * @param counter the counter
+ * @param value the value to add
+ * @return the counter before adding
+ */
+static long add_at_home(long* counter, const long& value) {
+	long old = *counter;
+	*counter = old + value;
+	return old;
+}
+
+/**
+ * @brief fails at the home node
+ * @param counter ignored
+ * @param value ignored
+ */
+static void fail_at_home(long* counter, const int& value) {
+	(void)counter;
+	(void)value;
+	throw std::logic_error("failed at home");
+}
+
+/**
+ * @brief Unittest that checks that functions run at the home node without lost updates
+ */
+TEST_F(communicationTest, InvokeAtHome) {
+	/* registering does not wait for the other nodes */
+	if(argo::node_id() == 0) {
+		argo::register_function(&add_at_home);
+	}
+	argo::barrier();
+	argo::register_function(&add_at_home);
+	argo::register_function(&fail_at_home);
+	/* one counter per page, over all home nodes */
+	const std::size_t stride = 4096 / sizeof(long);
+	const std::size_t counters = 64;
+	long* array = argo::conew_array<long>(counters * stride);
+	if(argo::node_id() == 0) {
+		for(std::size_t i = 0; i < counters; i++) {
+			array[i * stride] = 0;
+		}
+	}
+	argo::barrier();
+
+	const int rounds = 50;
+	std::vector<std::future<long>> results;
+	for(int r = 0; r < rounds; r++) {
+		for(std::size_t i = 0; i < counters; i++) {
+			results.push_back(argo::invoke_at_home(array + i * stride, &add_at_home, i + 1));
+		}
+	}
+	for(auto& result : results) {
+		long old = result.get();
+		ASSERT_GE(old, 0);
+	}
+	ASSERT_THROW(argo::invoke_at_home(argo::data_distribution::global_ptr<long>(array),
+			&fail_at_home, 0).get(), std::runtime_error);
+	long (*unregistered)(long*, const long&) = [](long* c, const long&) { return *c; };
+	ASSERT_THROW(argo::invoke_at_home(array, unregistered, 0), std::invalid_argument);
+	argo::barrier();
+
+	const long nodes = argo::number_of_nodes();
+	for(std::size_t i = 0; i < counters; i++) {
+		ASSERT_EQ(static_cast<long>(i + 1) * rounds * nodes, array[i * stride]);
+	}
+	/* the result of the last update of a counter is the total minus its value */
+	argo::barrier();
+	if(argo::node_id() == 0) {
+		long total = static_cast<long>(counters) * rounds * nodes;
+		ASSERT_EQ(total, argo::invoke_at_home(array + (counters - 1) * stride, &add_at_home, 1).get());
+	}
+	argo::barrier();
+	ASSERT_EQ(static_cast<long>(counters) * rounds * nodes + 1, array[(counters - 1) * stride]);
+
+	/* a home node waiting in a barrier still runs the invocations */
+	if(argo::node_id() != argo::data_distribution::global_ptr<long>(array).node()) {
+		argo::invoke_at_home(array, &add_at_home, 0).get();
+	}
+	argo::barrier();
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief The main function that runs the tests
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments
+ * @return 0 if success
+ */
+int main(int argc, char **argv) {
+	argo::init(size, cache_size);
+	::testing::InitGoogleTest(&argc, argv);
+	auto res = RUN_ALL_TESTS();
+	argo::finalize();
+	return res;
+}
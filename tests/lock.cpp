@@ -4,6 +4,7 @@
  * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
  */
 
+#include <atomic>
 #include <iostream>
 #include <thread>
 #include <unistd.h>
@@ -14,7 +15,9 @@
 #include "allocators/null_lock.hpp"
 #include "backend/backend.hpp"
 #include "synchronization/global_tas_lock.hpp"
+#include "synchronization/global_mcs_lock.hpp"
 #include "synchronization/cohort_lock.hpp"
+#include "synchronization/cohort_rw_lock.hpp"
 #include "synchronization/intranode/mcs_lock.hpp"
 #include "synchronization/intranode/ticket_lock.hpp"
 #include "data_distribution/global_ptr.hpp"
@@ -147,6 +150,73 @@ TEST_F(LockTest,TAS_lock_custom_barrier) {
 	argo::codelete_(counter);
 }
 
+/** @brief Checks that the global MCS lock provides mutual exclusion between nodes */
+TEST_F(LockTest, GlobalMCSLockCounter) {
+	using mcs_lock_t = argo::globallock::global_mcs_lock;
+	constexpr int rounds = 500;
+	mcs_lock_t::internal_field_type* mcs_field = argo::conew_<mcs_lock_t::internal_field_type>();
+	mcs_lock_t* lock = new mcs_lock_t(mcs_field);
+	counter = argo::conew_<int>(0);
+	argo::barrier();
+
+	for (int i = 0; i < rounds; i++) {
+		ASSERT_NO_THROW(lock->lock());
+		(*counter)++;
+		ASSERT_NO_THROW(lock->unlock());
+	}
+	argo::barrier();
+	ASSERT_EQ(rounds * argo::number_of_nodes(), *counter);
+
+	/* the lock is free again, so trying must succeed on at least one node */
+	int* successes = argo::conew_<int>(0);
+	argo::data_distribution::global_ptr<int> home_successes(successes);
+	argo::barrier();
+	bool res = lock->try_lock();
+	if (res) {
+		argo::backend::atomic::fetch_add(home_successes, 1);
+		lock->unlock();
+	}
+	argo::barrier();
+	ASSERT_LE(1, argo::backend::atomic::load(home_successes));
+
+	argo::codelete_(successes);
+	argo::codelete_(counter);
+	delete lock;
+	argo::codelete_(mcs_field);
+}
+
+/** @brief Checks that several global MCS locks can be held at the same time */
+TEST_F(LockTest, GlobalMCSLockNested) {
+	using mcs_lock_t = argo::globallock::global_mcs_lock;
+	constexpr int rounds = 200;
+	constexpr int locks = 4;
+	mcs_lock_t::internal_field_type* mcs_fields = argo::conew_array<mcs_lock_t::internal_field_type>(locks);
+	mcs_lock_t* lock[locks];
+	for (int i = 0; i < locks; i++) {
+		lock[i] = new mcs_lock_t(&mcs_fields[i]);
+	}
+	counter = argo::conew_<int>(0);
+	argo::barrier();
+
+	for (int i = 0; i < rounds; i++) {
+		for (int l = 0; l < locks; l++) {
+			lock[l]->lock();
+		}
+		(*counter)++;
+		for (int l = locks - 1; l >= 0; l--) {
+			lock[l]->unlock();
+		}
+	}
+	argo::barrier();
+	ASSERT_EQ(rounds * argo::number_of_nodes(), *counter);
+
+	argo::codelete_(counter);
+	for (int i = 0; i < locks; i++) {
+		delete lock[i];
+	}
+	argo::codelete_array(mcs_fields);
+}
+
 /**
  *@brief increments a shared counter to test locks
  *@param lock The lock to test
@@ -255,6 +325,249 @@ TEST_F(LockTest,StressCohortLock) {
 	delete cohort_lock;
 }
 
+/** @brief Checks the contention counters of the cohort lock */
+TEST_F(LockTest, CohortLockStatistics) {
+	constexpr int threads_per_node = 4;
+	std::thread threads[threads_per_node];
+	counter = argo::conew_<int>(0);
+	cohort_lock = new argo::globallock::cohort_lock();
+	argo::barrier();
+
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i] = std::thread(
+			increment_counter<argo::globallock::cohort_lock>, cohort_lock, counter);
+	}
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i].join();
+	}
+
+	auto stats = cohort_lock->statistics();
+	ASSERT_EQ(static_cast<std::size_t>(iter * threads_per_node), stats.acquisitions);
+	/* every release is exactly one kind of handover */
+	ASSERT_EQ(stats.acquisitions,
+			stats.numa_handovers + stats.node_handovers + stats.global_handovers);
+	ASSERT_LE(1ul, stats.global_handovers);
+	ASSERT_GT(threads_per_node, static_cast<int>(stats.max_queue_depth));
+	ASSERT_GE(stats.wait_time, stats.global_wait_time);
+	ASSERT_LT(0.0, stats.critical_section_time);
+	ASSERT_LE(64, stats.max_handover);
+	ASSERT_GE(8192, stats.max_handover);
+	ASSERT_LE(8, stats.max_handover_nodelock);
+	ASSERT_GE(128, stats.max_handover_nodelock);
+
+	argo::barrier();
+	ASSERT_EQ(iter * threads_per_node * argo::number_of_nodes(), *counter);
+	argo::codelete_(counter);
+	delete cohort_lock;
+}
+
+/** @brief Checks the global MCS lock with several threads on every node */
+TEST_F(LockTest, StressGlobalMCSLock) {
+	using mcs_lock_t = argo::globallock::global_mcs_lock;
+	constexpr int threads_per_node = 4;
+	std::thread threads[threads_per_node];
+	mcs_lock_t::internal_field_type* mcs_field = argo::conew_<mcs_lock_t::internal_field_type>();
+	mcs_lock_t* lock = new mcs_lock_t(mcs_field);
+	counter = argo::conew_<int>(0);
+	argo::barrier();
+
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i] = std::thread(increment_counter<mcs_lock_t>, lock, counter);
+	}
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i].join();
+	}
+
+	argo::barrier();
+	ASSERT_EQ(iter * threads_per_node * argo::number_of_nodes(), *counter);
+	argo::codelete_(counter);
+	delete lock;
+	argo::codelete_(mcs_field);
+}
+
+/** @brief Checks the MCS try_lock and holding more MCS locks than the node pool of a thread */
+TEST_F(LockTest, MCSTrylockAndNesting) {
+	constexpr int locks = 100;
+	mcs_lock = new argo::locallock::mcs_lock[locks];
+
+	ASSERT_TRUE(mcs_lock[0].try_lock());
+	ASSERT_FALSE(mcs_lock[0].is_contended());
+	std::thread([&] { ASSERT_FALSE(mcs_lock[0].try_lock()); }).join();
+	mcs_lock[0].unlock();
+
+	for (int i = 0; i < locks; i++) {
+		mcs_lock[i].lock();
+	}
+	/* release out of order, which returns nodes to the pool out of order */
+	for (int i = 0; i < locks; i += 2) {
+		mcs_lock[i].unlock();
+	}
+	for (int i = 1; i < locks; i += 2) {
+		mcs_lock[i].unlock();
+	}
+	for (int i = 0; i < locks; i++) {
+		ASSERT_TRUE(mcs_lock[i].try_lock());
+	}
+	for (int i = locks - 1; i >= 0; i--) {
+		mcs_lock[i].unlock();
+	}
+	delete[] mcs_lock;
+}
+
+/** @brief Checks locks that only make the counter they protect coherent */
+TEST_F(LockTest, ProtectedCounter) {
+	using mcs_lock_t = argo::globallock::global_mcs_lock;
+	constexpr int threads_per_node = 4;
+	std::thread threads[threads_per_node];
+	mcs_lock_t::internal_field_type* mcs_field = argo::conew_<mcs_lock_t::internal_field_type>();
+	mcs_lock_t* mcs = new mcs_lock_t(mcs_field);
+	cohort_lock = new argo::globallock::cohort_lock();
+	counter = argo::conew_<int>(0);
+	int* cohort_counter = argo::conew_<int>(0);
+	global_tas_lock->protect(counter);
+	mcs->protect(counter);
+	cohort_lock->protect(cohort_counter);
+	argo::barrier();
+
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i] = std::thread(increment_counter<mcs_lock_t>, mcs, counter);
+	}
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i].join();
+	}
+	argo::barrier();
+	increment_counter(global_tas_lock, counter);
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i] = std::thread(
+			increment_counter<argo::globallock::cohort_lock>, cohort_lock, cohort_counter);
+	}
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i].join();
+	}
+
+	argo::barrier();
+	ASSERT_EQ(iter * (threads_per_node + 1) * argo::number_of_nodes(), *counter);
+	ASSERT_EQ(iter * threads_per_node * argo::number_of_nodes(), *cohort_counter);
+	argo::codelete_(cohort_counter);
+	argo::codelete_(counter);
+	delete cohort_lock;
+	delete mcs;
+	argo::codelete_(mcs_field);
+}
+
+/** @brief Checks that a protected lock completes the atomics posted while holding it */
+TEST_F(LockTest, ProtectedPostedOps) {
+	using argo::data_distribution::global_ptr;
+	/* home the counter apart from the lock, whose updates would flush it */
+	constexpr std::size_t words = size / 2 / sizeof(int);
+	int* candidates = argo::conew_array<int>(words);
+	const argo::node_id_t lock_home = global_ptr<tas_lock::internal_field_type>(field).node();
+	counter = candidates;
+	for (std::size_t i = 0; i < words; i++) {
+		if (global_ptr<int>(&candidates[i]).node() != lock_home) {
+			counter = &candidates[i];
+			break;
+		}
+	}
+	if (argo::number_of_nodes() > 1) {
+		ASSERT_NE(lock_home, global_ptr<int>(counter).node());
+	}
+	int* plain = argo::conew_<int>(0);
+	global_ptr<int> home_counter(counter);
+	if (argo::node_id() == 0) {
+		argo::backend::atomic::store(home_counter, 0);
+	}
+	global_tas_lock->protect(counter);
+	global_tas_lock->protect(plain);
+	argo::barrier();
+
+	for (int i = 0; i < iter; i++) {
+		global_tas_lock->lock();
+		/* the previous holder completed its increment before handing over */
+		EXPECT_EQ(*plain, argo::backend::atomic::load(home_counter));
+		argo::backend::atomic::add(home_counter, 1);
+		(*plain)++;
+		global_tas_lock->unlock();
+	}
+
+	argo::barrier();
+	ASSERT_EQ(iter * argo::number_of_nodes(), argo::backend::atomic::load(home_counter));
+	ASSERT_EQ(iter * argo::number_of_nodes(), *plain);
+	argo::codelete_(plain);
+	argo::codelete_array(candidates);
+}
+
+/**
+ * @brief Reads and updates a pair of shared counters that must stay equal
+ * @param lock The reader-writer lock to test
+ * @param pair The two counters
+ * @param mismatches Incremented whenever a reader sees different counters
+ * @param writes Incremented by the number of updates done
+ */
+void read_write_pair(argo::globallock::cohort_rw_lock* lock, int* pair,
+		std::atomic<int>* mismatches, std::atomic<int>* writes) {
+	constexpr int rw_iter = 1000;
+	for (int i = 0; i < rw_iter; i++) {
+		if (i % 10 == 0) {
+			lock->lock();
+			pair[0]++;
+			pair[1]++;
+			lock->unlock();
+			(*writes)++;
+		} else {
+			lock->lock_shared();
+			if (pair[0] != pair[1]) {
+				(*mismatches)++;
+			}
+			lock->unlock_shared();
+		}
+	}
+}
+
+/**
+ * @brief Checks that readers of a reader-writer cohort lock never observe a partial update
+ * @param prefer_writers Whether the lock uses writer preference
+ * @return the number of updates done on this node
+ */
+int stress_cohort_rw_lock(bool prefer_writers) {
+	constexpr int threads_per_node = 4;
+	std::thread threads[threads_per_node];
+	std::atomic<int> mismatches(0);
+	std::atomic<int> writes(0);
+	int* pair = argo::conew_array<int>(2);
+	auto lock = new argo::globallock::cohort_rw_lock(prefer_writers);
+	if (argo::node_id() == 0) {
+		pair[0] = pair[1] = 0;
+	}
+	argo::barrier();
+
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i] = std::thread(read_write_pair, lock, pair, &mismatches, &writes);
+	}
+	for (int i = 0; i < threads_per_node; i++) {
+		threads[i].join();
+	}
+
+	argo::barrier();
+	EXPECT_EQ(0, mismatches.load());
+	EXPECT_EQ(writes.load() * argo::number_of_nodes(), pair[0]);
+	EXPECT_EQ(pair[0], pair[1]);
+	argo::barrier();
+	delete lock;
+	argo::codelete_array(pair);
+	return writes.load();
+}
+
+/** @brief Checks the reader-writer cohort lock with writer preference */
+TEST_F(LockTest, StressCohortRWLock) {
+	ASSERT_LT(0, stress_cohort_rw_lock(true));
+}
+
+/** @brief Checks the reader-writer cohort lock without writer preference */
+TEST_F(LockTest, StressCohortRWLockNoPreference) {
+	ASSERT_LT(0, stress_cohort_rw_lock(false));
+}
+
 /**
  * @brief The main function that runs the tests
  * @param argc Number of command line arguments
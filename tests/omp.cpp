@@ -87,6 +87,104 @@ TEST_F(ompTest, WriteAndRead) {
 	}
 }
 
+/**
+ * @brief Unittest that checks that the OpenMP threads of all nodes visit every element of an array once
+ */
+TEST_F(ompTest, ForEachLocal) {
+	/* elements that do not divide the pages, so some cross page boundaries */
+	struct triple { int a, b, c; };
+	triple *arr = argo::conew_array<triple>(amount);
+	int *visits = argo::conew_array<int>(amount);
+	if(argo::node_id() == 0) {
+		for(int i = 0; i < amount; i++) {
+			visits[i] = 0;
+		}
+	}
+	argo::barrier();
+
+	std::size_t local = 0;
+	std::size_t previous_end = 0;
+	for(auto& range : argo::local_ranges(arr, amount)) {
+		ASSERT_LT(range.begin, range.end);
+		ASSERT_LE(previous_end, range.begin);
+		previous_end = range.end;
+		local += range.end - range.begin;
+	}
+	ASSERT_EQ(static_cast<std::size_t>(amount), argo::allreduce(local));
+
+	for(int t = 1; t <= 4; t++) {
+		omp_set_num_threads(t);
+#pragma omp parallel
+		argo::for_each_local(arr, amount, [&](std::size_t i) {
+			arr[i].a = i;
+			__atomic_fetch_add(&visits[i], 1, __ATOMIC_RELAXED);
+		}, omp_get_thread_num(), omp_get_num_threads());
+		argo::barrier();
+	}
+	for(int i = 0; i < amount; i++) {
+		ASSERT_EQ(4, visits[i]);
+		ASSERT_EQ(i, arr[i].a);
+	}
+	argo::codelete_array(visits);
+	argo::codelete_array(arr);
+}
+
+/**
+ * @brief Unittest that writes and reads home data through local views
+ */
+TEST_F(ompTest, LocalView) {
+	int *arr = argo::conew_array<int>(amount);
+	argo::barrier();
+
+	/* split the local ranges at page boundaries, which are always contiguous */
+	std::vector<argo::index_range> pieces;
+	for(auto& range : argo::local_ranges(arr, amount)) {
+		for(std::size_t i = range.begin; i < range.end;) {
+			const std::size_t page_end = (reinterpret_cast<std::uintptr_t>(&arr[i]) / 4096 + 1) * 4096;
+			const std::size_t end = std::min<std::size_t>(range.end,
+					i + (page_end - reinterpret_cast<std::uintptr_t>(&arr[i])) / sizeof(int));
+			pieces.push_back({i, end});
+			i = end;
+		}
+	}
+	for(auto& piece : pieces) {
+		int* view = argo::local_view(arr + piece.begin, piece.end - piece.begin);
+#pragma omp parallel for
+		for(std::size_t i = piece.begin; i < piece.end; i++) {
+			view[i - piece.begin] = 2 * i;
+		}
+	}
+	argo::barrier();
+	for(int i = 0; i < amount; i++) {
+		ASSERT_EQ(2 * i, arr[i]);
+	}
+	argo::barrier();
+
+	if(argo::node_id() == 0) {
+		for(int i = 0; i < amount; i++) {
+			arr[i] = -i;
+		}
+	}
+	argo::barrier();
+	for(auto& piece : pieces) {
+		const int* view = argo::local_view(static_cast<const int*>(arr + piece.begin),
+				piece.end - piece.begin);
+		for(std::size_t i = piece.begin; i < piece.end; i++) {
+			ASSERT_EQ(-static_cast<int>(i), view[i - piece.begin]);
+		}
+	}
+
+	ASSERT_EQ(nullptr, argo::local_view(arr, 0));
+	std::size_t local = 0;
+	for(auto& piece : pieces) {
+		local += piece.end - piece.begin;
+	}
+	if(local < static_cast<std::size_t>(amount)) {
+		ASSERT_THROW(argo::local_view(arr, amount), std::invalid_argument);
+	}
+	argo::codelete_array(arr);
+}
+
 /**
  * @brief The main function that runs the tests
  * @param argc Number of command line arguments
@@ -4,7 +4,10 @@
  * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
  */
 
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <thread>
 
 #include <limits.h>
 #include <unistd.h>
@@ -20,6 +23,10 @@
 constexpr std::size_t size = 1<<30;
 /** @brief ArgoDSM cache size */
 constexpr std::size_t cache_size = size/8;
+/** @brief Size of the pages of the global memory */
+constexpr std::size_t page_size = 4096;
+/** @brief Time to wait for a background prefetch */
+constexpr std::chrono::seconds prefetch_timeout(10);
 
 namespace mem = argo::mempools;
 extern mem::global_memory_pool<>* default_global_mempool;
@@ -43,6 +50,43 @@ class PrefetchTest : public testing::Test {
 
 
 
+/**
+ * @brief Unittest that checks that private pages are not registered in the directory of their home
+ * @note The directory is not reset between tests, so this test comes
+ *       first, before the pages it uses have been accessed.
+ */
+TEST_F(PrefetchTest, AdvisePrivateDirectory) {
+	const std::size_t page_longs = page_size / sizeof(long);
+	long* lines = argo::conew_array<long>(4 * page_longs);
+	long* const first = reinterpret_cast<long*>(
+		(reinterpret_cast<std::uintptr_t>(lines) + page_size - 1) / page_size * page_size);
+	/* skip the first page, which may be loaded along with the page before */
+	long* const owned = first + page_longs;
+	long* const shared = owned + page_longs;
+	const argo::node_id_t owned_home = argo::data_distribution::global_ptr<long>(owned).node();
+	const argo::node_id_t shared_home = argo::data_distribution::global_ptr<long>(shared).node();
+	if(argo::node_id() != owned_home) {
+		argo::advise(owned, page_size, argo::advice::node_private);
+		static_cast<void>(*static_cast<volatile long*>(owned));
+	}
+	if(argo::node_id() != shared_home) {
+		static_cast<void>(*static_cast<volatile long*>(shared));
+	}
+	argo::barrier();
+	for(argo::node_id_t node = 0; node < argo::number_of_nodes(); node++) {
+		if(argo::node_id() == owned_home && node != owned_home) {
+			ASSERT_FALSE(argo::backend::_is_sharer(owned, node));
+		}
+		if(argo::node_id() == shared_home && node != shared_home) {
+			ASSERT_TRUE(argo::backend::_is_sharer(shared, node));
+		}
+	}
+	/* the hints outlive the allocation */
+	argo::advise(owned, page_size, argo::advice::normal);
+	argo::barrier();
+	argo::codelete_array(lines);
+}
+
 /**
  * @brief Unittest that checks that there is no error when accessing the last page in memory and tried to prefetch the page after.
  */
@@ -54,6 +98,190 @@ TEST_F(PrefetchTest, OutOfBounds) {
 	}
 }
 
+/**
+ * @brief Unittest that checks that explicitly prefetched data is correct and stays coherent
+ */
+TEST_F(PrefetchTest, ExplicitPrefetch) {
+	const std::size_t n = 1<<22;
+	int* array = argo::conew_array<int>(n);
+	if(argo::node_id() == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			array[i] = i;
+		}
+	}
+	argo::barrier();
+
+	argo::ticket first = argo::prefetch(array, n/2 * sizeof(int));
+	argo::ticket second = argo::prefetch(array + n/2, n/2 * sizeof(int));
+	argo::wait(second);
+	/* prefetches complete in order */
+	ASSERT_TRUE(argo::test(first));
+	ASSERT_TRUE(argo::test(second));
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ(static_cast<int>(i), array[i]);
+	}
+	argo::barrier();
+
+	/* prefetched data is invalidated as any cached data */
+	if(argo::node_id() == argo::number_of_nodes() - 1) {
+		for(std::size_t i = 0; i < n; i += 1000) {
+			array[i] = -1;
+		}
+	}
+	argo::barrier();
+	argo::wait(argo::prefetch(array, n * sizeof(int)));
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ((i % 1000 == 0) ? -1 : static_cast<int>(i), array[i]);
+	}
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief Unittest that checks that a prefetch does not have to be waited for
+ */
+TEST_F(PrefetchTest, UnwaitedPrefetch) {
+	const std::size_t n = 1<<20;
+	long* array = argo::conew_array<long>(n);
+	if(argo::node_id() == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			array[i] = i;
+		}
+	}
+	argo::barrier();
+	argo_ticket_t ticket = argo_prefetch(array, n * sizeof(long));
+	/* access the range while the prefetch may still be running */
+	long sum = 0;
+	for(std::size_t i = n; i > 0; i--) {
+		sum += array[i-1];
+	}
+	ASSERT_EQ(static_cast<long>(n) * (n - 1) / 2, sum);
+	argo_wait(ticket);
+	ASSERT_NE(0, argo_test(ticket));
+	/* prefetching outside of the global memory is ignored */
+	argo::wait(argo::prefetch(array + n - 1, size));
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief Unittest that checks that data stays coherent under the coherence hints
+ */
+TEST_F(PrefetchTest, AdviseCoherence) {
+	const std::size_t n = 1<<16;
+	const std::size_t page_longs = 4096 / sizeof(long);
+	long* array = argo::conew_array<long>(n);
+	if(argo::node_id() == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			array[i] = i;
+		}
+	}
+	argo::barrier();
+
+	/* read-only copies survive the barrier, and are dropped with the hint */
+	argo::advise(array, n * sizeof(long), argo::advice::read_only);
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ(static_cast<long>(i), array[i]);
+	}
+	argo::barrier();
+	argo::backend::selective_acquire(array, n * sizeof(long));
+	for(std::size_t i = 0; i < n; i += page_longs) {
+		ASSERT_TRUE(argo::backend::_is_cached(array + i));
+	}
+	argo::advise(array, n * sizeof(long), argo::advice::normal);
+	argo::barrier();
+	if(argo::node_id() == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			array[i] = 2 * i;
+		}
+	}
+	argo::barrier();
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ(static_cast<long>(2 * i), array[i]);
+	}
+	/* without the hint, pages written by another node are dropped */
+	argo::backend::selective_acquire(array, n * sizeof(long));
+	for(std::size_t i = 0; i < n; i += page_longs) {
+		if(argo::node_id() != 0 &&
+				argo::data_distribution::global_ptr<long>(array + i).node() != argo::node_id()) {
+			ASSERT_FALSE(argo::backend::_is_cached(array + i));
+		}
+	}
+	argo::barrier();
+
+	/* each node works on its own pages privately */
+	const std::size_t nodes = argo::number_of_nodes();
+	const std::size_t chunk = n / nodes / page_longs * page_longs;
+	const std::size_t begin = argo::node_id() * chunk;
+	const std::size_t end = (argo::node_id() == argo::number_of_nodes() - 1) ? n : begin + chunk;
+	argo::advise(array + begin, (end - begin) * sizeof(long), argo::advice::node_private);
+	argo::barrier();
+	for(std::size_t i = begin; i < end; i++) {
+		array[i] = -static_cast<long>(i);
+	}
+	for(std::size_t i = begin; i < end; i++) {
+		ASSERT_EQ(-static_cast<long>(i), array[i]);
+	}
+	argo::barrier();
+	argo::advise(array + begin, (end - begin) * sizeof(long), argo::advice::normal);
+	argo::barrier();
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ(-static_cast<long>(i), array[i]);
+	}
+	argo::codelete_array(array);
+}
+
+/**
+ * @brief Unittest that checks that data is correct under the access pattern hints
+ */
+TEST_F(PrefetchTest, AdviseAccessPattern) {
+	const std::size_t n = 1<<16;
+	const std::size_t page_longs = 4096 / sizeof(long);
+	long* array = argo::conew_array<long>(n);
+	long* output = argo::conew_array<long>(n);
+	if(argo::node_id() == 0) {
+		for(std::size_t i = 0; i < n; i++) {
+			array[i] = i;
+		}
+	}
+	argo::barrier();
+
+	/* a miss on a sequential page prefetches the following pages */
+	argo::advise(array, n * sizeof(long), argo::advice::sequential | argo::advice::read_only);
+	long* const ahead = array + 4 * page_longs;
+	if(argo::data_distribution::global_ptr<long>(ahead).node() != argo::node_id()) {
+		ASSERT_FALSE(argo::backend::_is_cached(ahead));
+	}
+	ASSERT_EQ(0, array[0]);
+	const auto deadline = std::chrono::steady_clock::now() + prefetch_timeout;
+	while(!argo::backend::_is_cached(ahead) && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::yield();
+	}
+	ASSERT_TRUE(argo::backend::_is_cached(ahead));
+	long sum = 0;
+	for(std::size_t i = 0; i < n; i++) {
+		sum += array[i];
+	}
+	ASSERT_EQ(static_cast<long>(n) * (n - 1) / 2, sum);
+	argo::advise(array, n * sizeof(long), argo::advice::random);
+	for(std::size_t i = 0, j = 0; i < n; i++, j = (j + 7919) % n) {
+		ASSERT_EQ(static_cast<long>(j), array[j]);
+	}
+
+	/* each node writes its own pages once */
+	const std::size_t nodes = argo::number_of_nodes();
+	const std::size_t chunk = n / nodes / page_longs * page_longs;
+	const std::size_t begin = argo::node_id() * chunk;
+	const std::size_t end = (argo::node_id() == argo::number_of_nodes() - 1) ? n : begin + chunk;
+	argo::advise(output + begin, (end - begin) * sizeof(long), argo::advice::write_once);
+	for(std::size_t i = begin; i < end; i++) {
+		output[i] = array[i] + 1;
+	}
+	argo::barrier();
+	for(std::size_t i = 0; i < n; i++) {
+		ASSERT_EQ(static_cast<long>(i + 1), output[i]);
+	}
+	argo::codelete_array(output);
+	argo::codelete_array(array);
+}
 
 /**
  * @brief The main function that runs the tests
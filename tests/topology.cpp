@@ -0,0 +1,117 @@
+/**
+ * @file
+ * @brief This file provides tests for the NUMA topology detection
+ * @copyright Eta Scale AB. Licensed under the Eta Scale Open Source License. See the LICENSE file for details.
+ */
+
+#include <set>
+
+#include <sched.h>
+
+#include "argo.hpp"
+#include "topology/topology.hpp"
+#include "gtest/gtest.h"
+
+/** @brief ArgoDSM memory size */
+constexpr std::size_t size = 1<<24;
+/** @brief ArgoDSM cache size */
+constexpr std::size_t cache_size = size;
+
+namespace topo = argo::topology;
+
+/**
+ * @brief Class for the gtests fixture tests. Will reset the allocators to a clean state for every test
+ */
+class topologyTest : public testing::Test {
+	protected:
+		topologyTest() {
+			argo_reset();
+			argo::barrier();
+		}
+
+		~topologyTest() {
+			argo::barrier();
+		}
+};
+
+/**
+ * @brief Unittest that checks that CPUs map to valid NUMA nodes
+ */
+TEST_F(topologyTest, NumaNodes) {
+	const int nodes = topo::numa_nodes();
+	ASSERT_GE(nodes, 1);
+	for(std::size_t i = 0; i < topo::pinnable_cpus(); i++) {
+		int cpu = topo::cpu_for_thread(i, topo::pin_policy::pack);
+		ASSERT_GE(topo::numa_node_of_cpu(cpu), 0);
+		ASSERT_LT(topo::numa_node_of_cpu(cpu), nodes);
+	}
+	ASSERT_GE(topo::current_numa_node(), 0);
+	ASSERT_LT(topo::current_numa_node(), nodes);
+	ASSERT_EQ(0, topo::numa_node_of_cpu(-1));
+}
+
+/**
+ * @brief Unittest that checks that both pinning policies use every allowed CPU once
+ */
+TEST_F(topologyTest, PinPolicies) {
+	const std::size_t cpus = topo::pinnable_cpus();
+	ASSERT_GE(cpus, 1ul);
+	for(auto policy : {topo::pin_policy::pack, topo::pin_policy::spread}) {
+		std::set<int> used;
+		for(std::size_t i = 0; i < cpus; i++) {
+			used.insert(topo::cpu_for_thread(i, policy));
+		}
+		ASSERT_EQ(cpus, used.size());
+		/* thread indices wrap around */
+		ASSERT_EQ(topo::cpu_for_thread(0, policy), topo::cpu_for_thread(cpus, policy));
+	}
+}
+
+/**
+ * @brief Unittest that checks the NUMA node order of the pinning policies
+ */
+TEST_F(topologyTest, PinOrder) {
+	const std::size_t cpus = topo::pinnable_cpus();
+	for(std::size_t i = 1; i < cpus; i++) {
+		/* packing never returns to a NUMA node it has left */
+		ASSERT_LE(topo::numa_node_of_cpu(topo::cpu_for_thread(i-1, topo::pin_policy::pack)),
+				topo::numa_node_of_cpu(topo::cpu_for_thread(i, topo::pin_policy::pack)));
+	}
+	std::set<int> domains;
+	for(std::size_t i = 0; i < cpus; i++) {
+		domains.insert(topo::numa_node_of_cpu(topo::cpu_for_thread(i, topo::pin_policy::pack)));
+	}
+	for(std::size_t i = 1; i < domains.size(); i++) {
+		/* spreading starts with one thread per NUMA node */
+		ASSERT_NE(topo::numa_node_of_cpu(topo::cpu_for_thread(i-1, topo::pin_policy::spread)),
+				topo::numa_node_of_cpu(topo::cpu_for_thread(i, topo::pin_policy::spread)));
+	}
+}
+
+/**
+ * @brief Unittest that checks that pinning a thread keeps it in the chosen NUMA node
+ */
+TEST_F(topologyTest, PinThread) {
+	const int cpu = topo::cpu_for_thread(0);
+	cpu_set_t old_set, cpuset;
+	ASSERT_EQ(0, sched_getaffinity(0, sizeof(old_set), &old_set));
+	CPU_ZERO(&cpuset);
+	CPU_SET(cpu, &cpuset);
+	ASSERT_EQ(0, sched_setaffinity(0, sizeof(cpuset), &cpuset));
+	ASSERT_EQ(topo::numa_node_of_cpu(cpu), topo::current_numa_node());
+	ASSERT_EQ(0, sched_setaffinity(0, sizeof(old_set), &old_set));
+}
+
+/**
+ * @brief The main function that runs the tests
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments
+ * @return 0 if success
+ */
+int main(int argc, char **argv) {
+	argo::init(size, cache_size);
+	::testing::InitGoogleTest(&argc, argv);
+	auto res = RUN_ALL_TESTS();
+	argo::finalize();
+	return res;
+}